@@ -92,9 +92,9 @@ void GridWidget::drawRectangle(unsigned short x, unsigned short y, unsigned shor
 
 
 
-QBrush GridWidget::getSpinColor(const Spin& spin)
+QBrush GridWidget::getSpinColor(const int type)
 {
-    switch (spin.getType())
+    switch (type)
     {
         case +1 : return QBrush(Qt::blue);
         case -1 : return QBrush(Qt::gray);
@@ -122,7 +122,7 @@ void GridWidget::draw_test()
             height_of_rectangular, 
             QPen(Qt::transparent), 
                 // getSpinColor( Spin(0, SPINTYPE(rand()%2*2)) 
-                getSpinColor( Spin(0, rand()%2 == 1 ? 1 : -1) 
+                getSpinColor( rand()%2 == 1 ? 1 : -1 
         ));
     }
 }
@@ -158,7 +158,7 @@ void GridWidget::draw( const Spinsystem& system )
             width_of_rectangular, 
             height_of_rectangular, 
             QPen(Qt::transparent), 
-                getSpinColor( system.getSpins().at(columns*row + column) 
+                getSpinColor( system.getLattice().getTypes().at(columns*row + column) 
         ));
     }
 }
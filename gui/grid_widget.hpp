@@ -52,7 +52,7 @@ public slots:
     void refresh();
     
 protected:
-    QBrush getSpinColor(const Spin& spin);
+    QBrush getSpinColor(const int type);
     void drawRectangle(unsigned short, unsigned short, unsigned short, unsigned short, QPen, QBrush);
     void makeNewScene();
     
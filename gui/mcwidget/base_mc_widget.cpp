@@ -51,20 +51,37 @@ void BaseMCWidget::setParameters(BaseParametersWidget* widget_ptr)
     
     if( ! parameters_linked.load() )
     {
-        MC.setParameters(prmsWidget);
+        MC.setParameters(prmsWidget->getParameters());
         MC.setup();
+        syncParameters();
         emit drawRequest(MC, steps_done.load());
     }
 }
 
 
 
+void BaseMCWidget::syncParameters()
+{
+    // the system may have adjusted its size, show the values actually used
+
+    qDebug() << __PRETTY_FUNCTION__;
+    Q_CHECK_PTR(prmsWidget);
+
+    const QSignalBlocker blocker(prmsWidget);
+    prmsWidget->setWidth(MC.getParameters().width);
+    prmsWidget->setHeight(MC.getParameters().height);
+}
+
+
+
 void BaseMCWidget::makeSystemNew()
 {
     qDebug() << __PRETTY_FUNCTION__;
     Q_CHECK_PTR(prmsWidget);
 
+    MC.setParameters(prmsWidget->getParameters());
     MC.setup();
+    syncParameters();
     steps_done.store(0);
     emit resetChartSignal();
     emit drawRequest(MC, steps_done.load());
@@ -77,6 +94,7 @@ void BaseMCWidget::makeRecordsNew()
     qDebug() << __PRETTY_FUNCTION__;
     Q_CHECK_PTR(prmsWidget);
 
+    MC.setParameters(prmsWidget->getParameters());
     MC.clearRecords();
     steps_done.store(0);
     emit resetChartSignal();
@@ -89,6 +107,7 @@ void BaseMCWidget::makeSystemRandom()
     qDebug() << __PRETTY_FUNCTION__;
     Q_CHECK_PTR(prmsWidget);
 
+    MC.setParameters(prmsWidget->getParameters());
     MC.clearRecords();
     MC.resetSpins();
     steps_done.store(0);
@@ -103,6 +122,9 @@ void BaseMCWidget::saveAction()
     qDebug() << __PRETTY_FUNCTION__;
     BASE_MC_WIDGET_ASSERT_ALL;
 
+    // the file key may have changed without further notice
+    MC.setParameters(prmsWidget->getParameters());
+    MC.adoptParameters();
     MC.print_data();
     MC.print_averages();
 }
@@ -115,30 +137,45 @@ void BaseMCWidget::server()
     qDebug() << __PRETTY_FUNCTION__;
     Q_CHECK_PTR(prmsWidget);
     
+    // only the snapshot of MC is used here, never the widgets
+    const Parameters& prms = MC.getParameters();
+    const std::string checkpoint = outputFile(prms, "checkpoint");
+    MC.setCheckpointFile(checkpoint);
+
     if( equilibration_mode.load() == true )
     {
-        while(simulation_running.load() && steps_done.load() < prmsWidget->getStepsEquil())
+        while(simulation_running.load() && steps_done.load() < prms.stepsEquil)
         {
-            MC.run(prmsWidget->getPrintFreq(), true);
-            steps_done.store(steps_done.load() + prmsWidget->getPrintFreq());
+            MC.run(prms.printFreq, true);
+            steps_done.store(steps_done.load() + prms.printFreq);
             
-            if( steps_done.load() >= prmsWidget->getStepsEquil() )
+            if( steps_done.load() >= prms.stepsEquil )
                 emit pauseBtn->clicked();
         }
     }
     else
     {
-        while(simulation_running.load() && steps_done.load() < prmsWidget->getStepsProd())
+        while(simulation_running.load() && steps_done.load() < prms.stepsProd)
         {
-            MC.run(prmsWidget->getPrintFreq(), false);
-            steps_done.store(steps_done.load() + prmsWidget->getPrintFreq());
+            MC.run(prms.printFreq, false);
+            steps_done.store(steps_done.load() + prms.printFreq);
             
-            if (steps_done.load() >= prmsWidget->getStepsProd())
+            if (steps_done.load() >= prms.stepsProd)
             {
                 emit pauseBtn->clicked();
             }
         }
     }
+
+    // every pause leaves a checkpoint, ising-cli --resume continues from it
+    try
+    {
+        MC.save_checkpoint(checkpoint);
+    }
+    catch(const std::exception& e)
+    {
+        Logger::getInstance().write_new_line("[gui]", e.what());
+    }
     
     emit pauseBtn->clicked();
 }
@@ -10,6 +10,7 @@
 #include "parameters/default_parameters_widget.hpp"
 #include "parameters/constrained_parameters_widget.hpp"
 #include "system/montecarlohost.hpp"
+#include "system/parametersio.hpp"
 #include <QWidget>
 #include <QPushButton>
 #include <QComboBox>
@@ -19,6 +20,7 @@
 #include <QtDebug>
 #include <QEvent>
 #include <QTimer>
+#include <QSignalBlocker>
 #include <iostream>
 #include <atomic>
 
@@ -60,6 +62,7 @@ protected:
     void operator=(const BaseMCWidget&) = delete;
 
     void server();
+    void syncParameters();
     
     BaseParametersWidget* prmsWidget = Q_NULLPTR;
     QPushButton* equilBtn = new QPushButton("Equilibration Run",this);
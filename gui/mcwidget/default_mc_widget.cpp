@@ -182,6 +182,8 @@ void DefaultMCWidget::abortAction()
     abortBtn->setEnabled(false);
     advancedRunBtn->setEnabled(true);
 
+    sweep.abort();
+
     // advancedCycleDone.store(true);
     // advancedEquilMode.store(true);
     // advancedValues.clear();
@@ -216,80 +218,115 @@ void DefaultMCWidget::advancedRunAction()
 
     MC.clearRecords();
 
-    double value = prmsWidget->getStartValue();
-    while( value <= prmsWidget->getStopValue() )
+    if( prmsWidget->getReplicaExchange() )
     {
-        prmsWidget->setAdvancedValue(value);
-        if( prmsWidget->getAdvancedRandomise() )
-        {
-            MC.resetSpins();
-        }
-        steps_done.store(0);
-        emit resetChartSignal();
-        equilibration_mode.store(true);
-        {
-            QEventLoop pause;
-            connect(this, &DefaultMCWidget::serverReturn, &pause, &QEventLoop::quit);
-            QFuture<void> future = QtConcurrent::run([&]
-            {
-                serverAdvanced();
-            });
-            pause.exec();
-        }
+        replicaExchangeRun();
+        emit abortBtn->clicked();
+        return;
+    }
+
+    sweepRun();
+    emit abortBtn->clicked();
+}
+
+
 
+void DefaultMCWidget::replicaExchangeRun()
+{
+    // all temperatures of the range at once, equilibration and production like a single run
+
+    qDebug() << __PRETTY_FUNCTION__;
+    Q_CHECK_PTR(prmsWidget);
+
+    if( prmsWidget->getStepValue() <= 0 )
+        return;
+
+    std::vector<double> temperatures;
+    for(double value = prmsWidget->getStartValue(); value <= prmsWidget->getStopValue(); value += prmsWidget->getStepValue())
+        temperatures.push_back(value);
+    if( temperatures.empty() )
+        return;
+
+    replicas.setup(prmsWidget->getParameters(), temperatures);
+
+    for(const bool equilibration : { true, false })
+    {
         steps_done.store(0);
-        equilibration_mode.store(false);
+        equilibration_mode.store(equilibration);
         emit resetChartSignal();
-        {
-            QEventLoop pause;
-            connect(this, &DefaultMCWidget::serverReturn, &pause, &QEventLoop::quit);
-            QFuture<void> future = QtConcurrent::run([&]
-            {
-                serverAdvanced();
-            });
-            pause.exec();
-        }
-        MC.print_averages();
-        MC.clearRecords();
 
-        value += prmsWidget->getStepValue();
+        QEventLoop pause;
+        connect(this, &DefaultMCWidget::serverReturn, &pause, &QEventLoop::quit);
+        QFuture<void> future = QtConcurrent::run([&]
+        {
+            serverReplicaExchange();
+        });
+        pause.exec();
     }
 
-    emit abortBtn->clicked();
+    replicas.print_averages();
+    replicas.clearRecords();
 }
 
 
 
-void DefaultMCWidget::serverAdvanced()
+void DefaultMCWidget::serverReplicaExchange()
 {
+    qDebug() << __PRETTY_FUNCTION__;
+
+    // the first host stands for all replicas, they share every parameter but T
+    const Parameters& prms = replicas.getHost(0).getParameters();
+    const unsigned long steps = equilibration_mode.load() ? prms.stepsEquil : prms.stepsProd;
+
+    while(simulation_running.load() && steps_done.load() < steps)
+    {
+        replicas.run(prms.printFreq, equilibration_mode.load());
+        steps_done.store(steps_done.load() + prms.printFreq);
+    }
+    emit serverReturn();
+}
+
+
+
+void DefaultMCWidget::sweepRun()
+{
+    // every value of the range is an independent job, the jobs share the threads of the parameters
+
     qDebug() << __PRETTY_FUNCTION__;
     Q_CHECK_PTR(prmsWidget);
-    
-    if( equilibration_mode.load() == true )
+
+    if( prmsWidget->getStepValue() <= 0 )
+        return;
+
+    std::vector<Parameters> points;
+    for(double value = prmsWidget->getStartValue(); value <= prmsWidget->getStopValue(); value += prmsWidget->getStepValue())
     {
-        while(simulation_running.load() && steps_done.load() < prmsWidget->getStepsEquil())
-        {
-            MC.run(prmsWidget->getPrintFreq(), true);
-            steps_done.store(steps_done.load() + prmsWidget->getPrintFreq());
-            
-            if( steps_done.load() >= prmsWidget->getStepsEquil() )
-                emit serverReturn();
-        }
+        prmsWidget->setAdvancedValue(value);
+        points.push_back(prmsWidget->getParameters());
     }
-    else
+    if( points.empty() )
+        return;
+
+    sweep.setup(points);
+
+    QEventLoop pause;
+    connect(this, &DefaultMCWidget::serverReturn, &pause, &QEventLoop::quit);
+    QFuture<void> future = QtConcurrent::run([&]
     {
-        while(simulation_running.load() && steps_done.load() < prmsWidget->getStepsProd())
+        try
         {
-            MC.run(prmsWidget->getPrintFreq(), false);
-            steps_done.store(steps_done.load() + prmsWidget->getPrintFreq());
-            
-            if (steps_done.load() >= prmsWidget->getStepsProd())
-            {
-                emit serverReturn();
-            }
+            sweep.run();
         }
-    }
-    emit serverReturn();
+        catch(const std::exception& e)
+        {
+            // the finished points are still written, as after an abort
+            Logger::getInstance().write_new_line("[gui]", e.what());
+        }
+        emit serverReturn();
+    });
+    pause.exec();
+
+    sweep.print_averages();
 }
 
 
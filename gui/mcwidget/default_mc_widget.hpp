@@ -8,6 +8,8 @@
 
 
 #include "mcwidget/base_mc_widget.hpp"
+#include "system/replicaexchange.hpp"
+#include "system/sweepexecutor.hpp"
 
 
 
@@ -37,7 +39,12 @@ private:
     QPushButton* advancedRunBtn = new QPushButton("Advanced Simulation Scheme", this);
     // std::vector<double> advancedValues {};
 
-    void serverAdvanced();
+    ReplicaExchange replicas {};
+    SweepExecutor sweep {};
+
+    void replicaExchangeRun();
+    void serverReplicaExchange();
+    void sweepRun();
 
 };
 
@@ -130,3 +130,26 @@ std::string BaseParametersWidget::getFileKey() const
 }
 
 
+Parameters BaseParametersWidget::getParameters() const
+{
+    // snapshot of all current values
+
+    Parameters prms;
+    prms.width = getWidth();
+    prms.height = getHeight();
+    prms.interaction = getInteraction();
+    prms.magnetic = getMagnetic();
+    prms.temperature = getTemperature();
+    prms.constrained = getConstrained();
+    prms.ratio = getRatio();
+    prms.wavelengthPattern = getWavelengthPattern();
+    prms.wavelength = getWavelength();
+    prms.scheme = getScheme();
+    prms.dynamics = getDynamics();
+    prms.threads = getThreads();
+    prms.stepsEquil = getStepsEquil();
+    prms.stepsProd = getStepsProd();
+    prms.printFreq = getPrintFreq();
+    prms.fileKey = getFileKey();
+    return prms;
+}
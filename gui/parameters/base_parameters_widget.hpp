@@ -8,6 +8,7 @@
 #endif
 
 #include "long_qspinbox.hpp"
+#include "system/parameters.hpp"
 #include <QWidget>
 #include <QGroupBox>
 #include <QLineEdit>
@@ -43,6 +44,7 @@ public:
     unsigned long getStepsProd() const;
     unsigned int  getPrintFreq() const;
     std::string getFileKey() const;
+    Parameters  getParameters() const;
 
     virtual double getMagnetic() const = 0;
     virtual double getRatio() const = 0;
@@ -52,7 +54,10 @@ public:
     virtual double getStartValue() const = 0;
     virtual double getStopValue() const = 0;
     virtual double getStepValue() const = 0;
-    virtual bool   getAdvancedRandomise() const = 0;
+    virtual bool   getReplicaExchange() const = 0;
+    virtual UPDATESCHEME getScheme() const = 0;
+    virtual DYNAMICS     getDynamics() const = 0;
+    virtual unsigned int getThreads() const = 0;
     
     virtual void setAdvancedValue(const double) = 0;
     
@@ -344,8 +344,26 @@ double ConstrainedParametersWidget::getStepValue() const
     return 0;
 }
 
-bool ConstrainedParametersWidget::getAdvancedRandomise() const
+bool ConstrainedParametersWidget::getReplicaExchange() const
 {
     return false;
 }
-         
\ No newline at end of file
+         
+
+
+UPDATESCHEME ConstrainedParametersWidget::getScheme() const
+{
+    return UPDATESCHEME::RANDOM;
+}
+
+
+DYNAMICS ConstrainedParametersWidget::getDynamics() const
+{
+    return DYNAMICS::METROPOLIS;
+}
+
+
+unsigned int ConstrainedParametersWidget::getThreads() const
+{
+    return 1;
+}
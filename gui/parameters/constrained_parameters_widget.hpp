@@ -44,7 +44,10 @@ public:
     double getStartValue() const;
     double getStopValue() const;
     double getStepValue() const;
-    bool   getAdvancedRandomise() const;
+    bool   getReplicaExchange() const;
+    UPDATESCHEME getScheme() const;
+    DYNAMICS     getDynamics() const;
+    unsigned int getThreads() const;
 
     void setAdvancedValue(const double);
     
@@ -14,7 +14,11 @@
     Q_CHECK_PTR(startValueSpinBox);  \
     Q_CHECK_PTR(stepValueSpinBox);   \
     Q_CHECK_PTR(stopValueSpinBox);   \
-    Q_CHECK_PTR(magneticSpinBox);    
+    Q_CHECK_PTR(replicaExchangeCheckBox); \
+    Q_CHECK_PTR(magneticSpinBox);    \
+    Q_CHECK_PTR(schemeComboBox);     \
+    Q_CHECK_PTR(dynamicsComboBox);   \
+    Q_CHECK_PTR(threadsSpinBox);
 
 
 
@@ -40,6 +44,7 @@ DefaultParametersWidget::DefaultParametersWidget(QWidget* parent)
     mainLayout->addWidget(randomiseBtn);
     mainLayout->addWidget(createEquilBox());
     mainLayout->addWidget(createProdBox());
+    mainLayout->addWidget(createAlgorithmBox());
     mainLayout->addWidget(createOutputBox());
     mainLayout->addWidget(createAdvancedOptionsBox());
     setDefault();
@@ -52,6 +57,9 @@ DefaultParametersWidget::DefaultParametersWidget(QWidget* parent)
     connect( stepsEquilSpinBox , static_cast<void (QtLongLongSpinBox::*)(qlonglong)>(&QtLongLongSpinBox::valueChanged), this, &DefaultParametersWidget::valueChanged );
     connect( stepsProdSpinBox  , static_cast<void (QtLongLongSpinBox::*)(qlonglong)>(&QtLongLongSpinBox::valueChanged), this, &DefaultParametersWidget::valueChanged );
     connect( printFreqSpinBox  , static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, &DefaultParametersWidget::valueChanged );
+    connect( schemeComboBox    , static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, &DefaultParametersWidget::valueChanged );
+    connect( dynamicsComboBox  , static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, &DefaultParametersWidget::valueChanged );
+    connect( threadsSpinBox    , static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, &DefaultParametersWidget::valueChanged );
     
     connect( heightSpinBox     , static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, &DefaultParametersWidget::valueChanged );
     connect( widthSpinBox      , static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, &DefaultParametersWidget::valueChanged );
@@ -193,6 +201,49 @@ QGroupBox* DefaultParametersWidget::createProdBox()
 }
 
 
+QGroupBox* DefaultParametersWidget::createAlgorithmBox()
+{
+    qDebug() << __PRETTY_FUNCTION__;
+    DEFAULT_PARAMETERS_WIDGET_ASSERT_ALL
+
+    // the group
+    QGroupBox* labelBox = new QGroupBox("Algorithm");
+
+    // the update schemes, steps count single flips or full sweeps
+    schemeComboBox->addItem("random single spin flips", static_cast<int>(UPDATESCHEME::RANDOM));
+    schemeComboBox->addItem("sequential sweeps (no detailed balance)", static_cast<int>(UPDATESCHEME::SEQUENTIAL));
+    schemeComboBox->addItem("permuted sweeps (no detailed balance)", static_cast<int>(UPDATESCHEME::PERMUTATION));
+    schemeComboBox->addItem("checkerboard sweeps", static_cast<int>(UPDATESCHEME::CHECKERBOARD));
+    schemeComboBox->addItem("64 replicas, multi-spin coded", static_cast<int>(UPDATESCHEME::MULTISPIN));
+    schemeComboBox->addItem("Wolff cluster flips", static_cast<int>(UPDATESCHEME::WOLFF));
+    schemeComboBox->addItem("Swendsen-Wang (parallel)", static_cast<int>(UPDATESCHEME::SWENDSENWANG));
+    schemeComboBox->addItem("n-fold way (continuous time)", static_cast<int>(UPDATESCHEME::NFOLDWAY));
+    schemeComboBox->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+
+    dynamicsComboBox->addItem("Metropolis", static_cast<int>(DYNAMICS::METROPOLIS));
+    dynamicsComboBox->addItem("heat-bath", static_cast<int>(DYNAMICS::HEATBATH));
+    dynamicsComboBox->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+
+    threadsSpinBox->setMinimum(0);
+    threadsSpinBox->setMaximum(256);
+    threadsSpinBox->setSingleStep(1);
+    threadsSpinBox->setSpecialValueText("all");
+    threadsSpinBox->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+
+    // the layout
+    QFormLayout* formLayout = new QFormLayout();
+    formLayout->setLabelAlignment(Qt::AlignLeft);
+    formLayout->addRow("update scheme", schemeComboBox);
+    formLayout->addRow("dynamics", dynamicsComboBox);
+    formLayout->addRow("threads", threadsSpinBox);
+
+    // set group layout
+    labelBox->setLayout(formLayout);
+
+    return labelBox;
+}
+
+
 QGroupBox* DefaultParametersWidget::createAdvancedOptionsBox()
 {
     qDebug() << __PRETTY_FUNCTION__;
@@ -233,9 +284,10 @@ QGroupBox* DefaultParametersWidget::createAdvancedOptionsBox()
     stepValueSpinBox->setMinimumWidth(55);
     stepValueSpinBox->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
 
-    // set up advancedRandomiseCheckBox:
-    advancedRandomiseCheckBox->setCheckable(true);
-    advancedRandomiseCheckBox->setChecked(false);
+    // set up replicaExchangeCheckBox:
+    replicaExchangeCheckBox->setCheckable(true);
+    replicaExchangeCheckBox->setChecked(false);
+    replicaExchangeCheckBox->setToolTip("all temperatures at once, swapping configurations between neighbouring temperatures");
 
     
     // the layout 
@@ -258,7 +310,7 @@ QGroupBox* DefaultParametersWidget::createAdvancedOptionsBox()
     rangeOptions->addWidget(stopValueSpinBox);
     formLayout->addRow("start : step : end", rangeOptions);
 
-    formLayout->addRow("randomise between runs", advancedRandomiseCheckBox);
+    formLayout->addRow("replica exchange (T only)", replicaExchangeCheckBox);
 
     advancedOptionsBox->setLayout(formLayout);
     return advancedOptionsBox;
@@ -284,7 +336,10 @@ void DefaultParametersWidget::setReadOnly(bool flag)
     stepValueSpinBox->setReadOnly(flag);
     stopValueSpinBox->setReadOnly(flag);
     magneticSpinBox->setReadOnly(flag);
-    advancedRandomiseCheckBox->setEnabled(!flag);
+    replicaExchangeCheckBox->setEnabled(!flag);
+    schemeComboBox->setEnabled(!flag);
+    dynamicsComboBox->setEnabled(!flag);
+    threadsSpinBox->setReadOnly(flag);
 }
 
 
@@ -306,7 +361,10 @@ void DefaultParametersWidget::setDefault()
     stepValueSpinBox->setValue(0.1);
     stopValueSpinBox->setValue(0);
     magneticSpinBox->setValue(0.0);
-    advancedRandomiseCheckBox->setChecked(false);
+    replicaExchangeCheckBox->setChecked(false);
+    schemeComboBox->setCurrentIndex(0);
+    dynamicsComboBox->setCurrentIndex(0);
+    threadsSpinBox->setValue(0);
 
     #ifndef NDEBUG
         heightSpinBox->setValue(6);
@@ -390,10 +448,31 @@ double DefaultParametersWidget::getStepValue() const
     return stepValueSpinBox->value();
 }
 
-bool DefaultParametersWidget::getAdvancedRandomise() const
+bool DefaultParametersWidget::getReplicaExchange() const
 {
-    Q_CHECK_PTR(advancedRandomiseCheckBox);
-    return advancedRandomiseCheckBox->isChecked();
+    // replica exchange only works for a range of temperatures
+    Q_CHECK_PTR(replicaExchangeCheckBox);
+    Q_CHECK_PTR(advancedComboBox);
+    return replicaExchangeCheckBox->isChecked() && advancedComboBox->currentIndex() == 0;
+}
+
+
+UPDATESCHEME DefaultParametersWidget::getScheme() const
+{
+    Q_CHECK_PTR(schemeComboBox);
+    return static_cast<UPDATESCHEME>(schemeComboBox->currentData().toInt());
+}
+
+
+DYNAMICS DefaultParametersWidget::getDynamics() const
+{
+    Q_CHECK_PTR(dynamicsComboBox);
+    return static_cast<DYNAMICS>(dynamicsComboBox->currentData().toInt());
+}
+
+
+unsigned int DefaultParametersWidget::getThreads() const
+{
+    Q_CHECK_PTR(threadsSpinBox);
+    return threadsSpinBox->value();
 }
-                
-                
\ No newline at end of file
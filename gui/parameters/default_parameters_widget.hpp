@@ -44,7 +44,10 @@ public:
     double getStartValue() const;
     double getStopValue() const;
     double getStepValue() const;
-    bool   getAdvancedRandomise() const;
+    bool   getReplicaExchange() const;
+    UPDATESCHEME getScheme() const;
+    DYNAMICS     getDynamics() const;
+    unsigned int getThreads() const;
 
     void setAdvancedValue(const double);
     
@@ -68,6 +71,12 @@ private:
     QDoubleSpinBox* stopValueSpinBox = new QDoubleSpinBox(this);
     QDoubleSpinBox* stepValueSpinBox = new QDoubleSpinBox(this);
 
-    QCheckBox*  advancedRandomiseCheckBox = new QCheckBox(this);
+    QCheckBox*  replicaExchangeCheckBox = new QCheckBox(this);
+
+    QComboBox* schemeComboBox = new QComboBox(this);
+    QComboBox* dynamicsComboBox = new QComboBox(this);
+    QSpinBox*  threadsSpinBox = new QSpinBox(this);
+
+    QGroupBox* createAlgorithmBox();
 
 };
@@ -8,6 +8,7 @@
 #include <type_traits>
 #include <string>
 #include <sys/stat.h>
+#include "random.hpp"
 
 // to be able to pass my own class objects to a stream via << :
 template<typename T>
@@ -20,11 +21,14 @@ auto operator<<(std::ostream& stream, const T& t) -> decltype(t.print(stream),st
 namespace enhance
 {
 
+    // engine behind all random numbers of the program, exchangeable here
+    typedef Xoshiro256pp    Engine;
+
     extern unsigned int     seed;
-    extern std::mt19937_64  rand_engine;
+    extern Engine           rand_engine;
 
-    double random_double(double, double);
-    int    random_int(int, int);
+    inline double random_double(double, double);
+    inline int    random_int(int, int);
 
 
     // Type aliasing
@@ -40,25 +44,37 @@ namespace enhance
     static struct __random_iterator
     {
         template<typename T>
-        constexpr inline decltype(auto) operator() ( const T& _container ) const -> typename T::const_iterator
+        constexpr inline auto operator() ( const T& _container ) const -> typename T::const_iterator
         {
             static_assert( HaveRandomAccessIterator<T>::value, "T has no std::random_access_iterator_tag in __enhance::random_iterator::operator()" );
-            std::uniform_int_distribution<std::size_t> dist(0,_container.size()-1);
-            return std::cbegin(_container) + dist(rand_engine);
+            return std::cbegin(_container) + bounded(rand_engine, _container.size());
         }
         
         template<typename T>
-        constexpr inline decltype(auto) operator() ( T& _container ) -> typename T::iterator
+        constexpr inline auto operator() ( T& _container ) -> typename T::iterator
         {
             static_assert( HaveRandomAccessIterator<T>::value, "T has no std::random_access_iterator_tag in __enhance::random_iterator::operator()" );
-            std::uniform_int_distribution<std::size_t> dist(0,_container.size()-1);
-            return std::begin(_container) + dist(rand_engine);
+            return std::begin(_container) + bounded(rand_engine, _container.size());
         }
     } random_iterator __attribute__((unused));
 
 
     // check if a file exists
     bool fileExists(const std::string&);
+
+
+
+    // random double from [a,b)
+    inline double random_double(double a, double b)
+    {
+        return a + (b - a) * canonical(rand_engine);
+    }
+
+    // random int from [a,b]
+    inline int random_int(int a, int b)
+    {
+        return a + static_cast<int>( bounded(rand_engine, static_cast<std::uint64_t>(static_cast<std::int64_t>(b) - a) + 1) );
+    }
 }
 
 
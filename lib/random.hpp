@@ -0,0 +1,252 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <cmath>
+
+
+
+namespace enhance
+{
+
+    // All engines below produce full 64 bit words and satisfy UniformRandomBitGenerator,
+    // so they work with the standard distributions and algorithms as well.
+
+    // splitmix64, mainly used to expand a single seed into the state of other engines
+    class SplitMix64
+    {
+    public:
+        typedef std::uint64_t result_type;
+
+    private:
+        result_type state {0};
+
+    public:
+        explicit SplitMix64(const result_type value = 0) : state(value) {}
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        inline void seed(const result_type value) { state = value; }
+        inline result_type operator()()
+        {
+            result_type z = (state += 0x9e3779b97f4a7c15);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+            return z ^ (z >> 31);
+        }
+    };
+
+
+
+    // xoshiro256++ by Blackman and Vigna, 32 bytes of state, all output bits are usable
+    class Xoshiro256pp
+    {
+    public:
+        typedef std::uint64_t result_type;
+
+    private:
+        std::array<result_type, 4> state {};
+
+        static inline result_type rotl(const result_type x, const int k) { return (x << k) | (x >> (64 - k)); }
+
+    public:
+        explicit Xoshiro256pp(const result_type value = 0) { seed(value); }
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        inline void seed(const result_type value)
+        {
+            SplitMix64 expand(value);
+            for(auto& word : state)
+                word = expand();
+        }
+
+        // full state, e.g. to continue a stream after a restart
+        inline const std::array<result_type, 4>& getState() const { return state; }
+        inline void setState(const std::array<result_type, 4>& _state) { state = _state; }
+
+        inline result_type operator()()
+        {
+            const result_type result = rotl(state[0] + state[3], 23) + state[0];
+            const result_type t = state[1] << 17;
+            state[2] ^= state[0];
+            state[3] ^= state[1];
+            state[1] ^= state[2];
+            state[0] ^= state[3];
+            state[2] ^= t;
+            state[3] = rotl(state[3], 45);
+            return result;
+        }
+    };
+
+
+
+    // Philox4x32-10 by Salmon et al., a counter-based engine:
+    // output block n is a keyed bijection of the 128 bit counter (n, stream),
+    // so any position of any stream can be reached without generating the numbers before it.
+    class Philox4x32
+    {
+    public:
+        typedef std::uint64_t result_type;
+        typedef std::array<std::uint32_t, 4> block_type;
+
+    private:
+        std::array<std::uint32_t, 2> key {};
+        block_type counter {};
+        block_type output {};
+        unsigned int used {4};      // 32 bit words of output already handed out
+
+        static inline void round(block_type&, const std::array<std::uint32_t, 2>&);
+
+    public:
+        explicit Philox4x32(const result_type value = 0, const result_type stream = 0) { seed(value); setStream(stream); }
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        static inline block_type block(const block_type&, const std::array<std::uint32_t, 2>&);
+
+        inline void seed(const result_type value)
+        {
+            key = {{ static_cast<std::uint32_t>(value), static_cast<std::uint32_t>(value >> 32) }};
+            used = 4;
+        }
+
+        // upper half of the counter selects an independent stream, the lower half counts blocks
+        inline void setStream(const result_type stream)
+        {
+            counter = {{ 0, 0, static_cast<std::uint32_t>(stream), static_cast<std::uint32_t>(stream >> 32) }};
+            used = 4;
+        }
+
+        // jump to block n of the current stream, every block yields two 64 bit numbers
+        inline void setPosition(const result_type n)
+        {
+            counter[0] = static_cast<std::uint32_t>(n);
+            counter[1] = static_cast<std::uint32_t>(n >> 32);
+            used = 4;
+        }
+
+        inline result_type operator()()
+        {
+            if( used == 4 )
+            {
+                output = block(counter, key);
+                if( ++counter[0] == 0 )
+                    ++counter[1];
+                used = 0;
+            }
+            const result_type result = static_cast<result_type>(output[used]) | static_cast<result_type>(output[used+1]) << 32;
+            used += 2;
+            return result;
+        }
+
+        // fill a buffer block by block without going through the output buffer
+        inline void generate(result_type* first, result_type* const last)
+        {
+            while( used != 4 && first != last )
+                *first++ = (*this)();
+            for( ; last - first >= 2; first += 2 )
+            {
+                const block_type words = block(counter, key);
+                if( ++counter[0] == 0 )
+                    ++counter[1];
+                first[0] = static_cast<result_type>(words[0]) | static_cast<result_type>(words[1]) << 32;
+                first[1] = static_cast<result_type>(words[2]) | static_cast<result_type>(words[3]) << 32;
+            }
+            if( first != last )
+                *first = (*this)();
+        }
+    };
+
+
+
+    inline void Philox4x32::round(block_type& c, const std::array<std::uint32_t, 2>& k)
+    {
+        const std::uint64_t product0 = static_cast<std::uint64_t>(0xD2511F53) * c[0];
+        const std::uint64_t product1 = static_cast<std::uint64_t>(0xCD9E8D57) * c[2];
+        c = {{ static_cast<std::uint32_t>(product1 >> 32) ^ c[1] ^ k[0], static_cast<std::uint32_t>(product1),
+               static_cast<std::uint32_t>(product0 >> 32) ^ c[3] ^ k[1], static_cast<std::uint32_t>(product0) }};
+    }
+
+
+
+    inline Philox4x32::block_type Philox4x32::block(const block_type& _counter, const std::array<std::uint32_t, 2>& _key)
+    {
+        // ten rounds with a Weyl sequence of keys
+
+        block_type c = _counter;
+        std::array<std::uint32_t, 2> k = _key;
+        for(unsigned int r=0; r<9; ++r)
+        {
+            round(c, k);
+            k[0] += 0x9E3779B9;
+            k[1] += 0xBB67AE85;
+        }
+        round(c, k);
+        return c;
+    }
+
+
+
+    // seed of stream number `stream` derived from a master seed: one Philox block keyed with the master seed,
+    // so every stream can be set up on its own and different numbers give unrelated seeds
+    inline std::uint64_t streamSeed(const std::uint64_t master, const std::uint64_t stream)
+    {
+        const auto words = Philox4x32::block({{ 0, 0, static_cast<std::uint32_t>(stream), static_cast<std::uint32_t>(stream >> 32) }},
+                                             {{ static_cast<std::uint32_t>(master), static_cast<std::uint32_t>(master >> 32) }});
+        return static_cast<std::uint64_t>(words[0]) | static_cast<std::uint64_t>(words[1]) << 32;
+    }
+
+
+
+    // unbiased integer from [0, range), Lemire's multiply-and-reject method:
+    // a division is only needed in the rare case of a possibly biased low product
+    template<typename ENGINE>
+    inline std::uint64_t bounded(ENGINE& engine, const std::uint64_t range)
+    {
+        __extension__ typedef unsigned __int128 uint128;
+
+        uint128 product = static_cast<uint128>(engine()) * range;
+        std::uint64_t low = static_cast<std::uint64_t>(product);
+        if( low < range )
+        {
+            const std::uint64_t threshold = (0 - range) % range;
+            while( low < threshold )
+            {
+                product = static_cast<uint128>(engine()) * range;
+                low = static_cast<std::uint64_t>(product);
+            }
+        }
+        return static_cast<std::uint64_t>(product >> 64);
+    }
+
+
+
+    // double from [0,1) with all 53 bits of the mantissa random
+    template<typename ENGINE>
+    inline double canonical(ENGINE& engine)
+    {
+        return std::ldexp(static_cast<double>(engine() >> 11), -53);
+    }
+
+
+
+    // fill a buffer with raw 64 bit numbers, engines may provide a faster generate() member
+    template<typename ENGINE>
+    inline void generate(ENGINE& engine, std::uint64_t* first, std::uint64_t* const last)
+    {
+        for( ; first != last; ++first)
+            *first = engine();
+    }
+
+    inline void generate(Philox4x32& engine, std::uint64_t* first, std::uint64_t* const last)
+    {
+        engine.generate(first, last);
+    }
+
+}
@@ -0,0 +1,397 @@
+#include "system/montecarlohost.hpp"
+#include "system/sweepexecutor.hpp"
+#include "system/replicaexchange.hpp"
+#include "system/parametersio.hpp"
+#include "system/jobscheduler.hpp"
+#include "system/columnardata.hpp"
+#include "lib/enhance.hpp"
+#include "utility/logger.hpp"
+#include <iostream>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+
+
+
+// Command line driver without any user interface, for batch queues:
+//
+//   ising-cli [config file ...] [--key value | --key=value | key=value ...]
+//   ising-cli --jobfile <file> [--journal <file>] [--workers N] [--memory MB] [--seed N]
+//   ising-cli --convert <file>.bdata
+//
+// Config files hold the same keys as "key = value" lines, later settings win.
+// Besides the simulation parameters (see parametersio.hpp) the keys are
+//   seed                          master seed, random if not given
+//   vary, start, step, stop       sweep of T, J or B, every value is an independent run
+//   replicaExchange               sweep all temperatures at once with replica exchange
+//   resume                        continue a single run from <fileKey>.checkpoint
+// Output goes to <fileKey>.data for single runs and to <fileKey>.averaged_data for all runs,
+// with dataFormat = binary to <fileKey>.bdata, which --convert turns into the text layout <fileKey>.data.
+// Single runs write <fileKey>.checkpoint every checkpointInterval seconds and on SIGINT or SIGTERM,
+// a resumed run takes all parameters from the checkpoint and ends exactly like an uninterrupted one.
+// With trajectoryInterval set, lattice snapshots go to <fileKey>.trajectory (<fileKey>.<i>.trajectory
+// for the points of a sweep), see trajectory.hpp.
+// A job file describes a whole campaign of runs, see jobscheduler.hpp, its journal
+// defaults to <jobfile>.journal and lets an interrupted campaign continue.
+
+namespace
+{
+    struct RunOptions
+    {
+        bool          seeded {false};
+        unsigned int  seed {0};
+        std::string   vary {};
+        double        start {0};
+        double        step {0};
+        double        stop {0};
+        bool          replicaExchange {false};
+        bool          resume {false};
+        std::string   jobfile {};
+        std::string   journal {};
+        unsigned int  workers {0};
+        std::size_t   memory {0};       // MB
+        std::string   convert {};
+    };
+
+
+    void usage(std::ostream& stream)
+    {
+        stream << "usage: ising-cli [config file ...] [--key value | --key=value | key=value ...]\n"
+               << "\n"
+               << "simulation keys and defaults:\n";
+        writeParameters(stream, Parameters());
+        stream << "\n"
+               << "run keys:\n"
+               << "seed = <master seed, random if not given>\n"
+               << "vary = T | J | B, start = <value>, step = <value>, stop = <value>\n"
+               << "replicaExchange = false\n"
+               << "resume = false\n"
+               << "\n"
+               << "campaigns:\n"
+               << "jobfile = <file>, journal = <jobfile>.journal, workers = <cores>, memory = <limit in MB>\n"
+               << "\n"
+               << "binary data:\n"
+               << "convert = <file>.bdata          writes the text layout to <file>.data\n"
+               << "\n"
+               << "schemes:  random sequential permutation checkerboard multispin wolff swendsenwang nfoldway\n"
+               << "dynamics: metropolis heatbath\n"
+               << "data formats: text binary\n";
+    }
+
+
+    void apply(Parameters& prms, RunOptions& options, const std::string& key, const std::string& value)
+    {
+        if( key == "seed" )
+        {
+            options.seeded = true;
+            options.seed = toNumber<unsigned int>(key, value);
+        }
+        else if( key == "vary" )
+        {
+            if( value != "T" && value != "J" && value != "B" )
+                throw std::invalid_argument("vary has to be T, J or B");
+            options.vary = value;
+        }
+        else if( key == "start" )               options.start = toNumber<double>(key, value);
+        else if( key == "step" )                options.step = toNumber<double>(key, value);
+        else if( key == "stop" )                options.stop = toNumber<double>(key, value);
+        else if( key == "replicaExchange" )     options.replicaExchange = toBool(value);
+        else if( key == "resume" )              options.resume = toBool(value);
+        else if( key == "jobfile" )             options.jobfile = value;
+        else if( key == "journal" )             options.journal = value;
+        else if( key == "workers" )             options.workers = toNumber<unsigned int>(key, value);
+        else if( key == "memory" )              options.memory = toNumber<std::size_t>(key, value);
+        else if( key == "convert" )             options.convert = value;
+        else if( ! setParameter(prms, key, value) )
+            throw std::invalid_argument("unknown key " + key);
+    }
+
+
+    void parse(const int argc, char* argv[], Parameters& prms, RunOptions& options)
+    {
+        // config files and single settings are applied in the order given
+
+        for(int i=1; i<argc; ++i)
+        {
+            const std::string argument = argv[i];
+            if( argument.compare(0, 2, "--") == 0 )
+            {
+                std::string key = argument.substr(2);
+                std::string value;
+                const auto equals = key.find('=');
+                if( equals != std::string::npos )
+                {
+                    value = key.substr(equals + 1);
+                    key = key.substr(0, equals);
+                }
+                else if( i+1 < argc && std::string(argv[i+1]).compare(0, 2, "--") != 0 )
+                {
+                    value = argv[++i];
+                }
+
+                if( key == "config" )
+                {
+                    for(const auto& setting : readSettings(value))
+                        apply(prms, options, setting.first, setting.second);
+                }
+                else
+                {
+                    apply(prms, options, key, value);
+                }
+            }
+            else if( argument.find('=') != std::string::npos )
+            {
+                const auto setting = splitSetting(argument);
+                apply(prms, options, setting.first, setting.second);
+            }
+            else
+            {
+                for(const auto& setting : readSettings(argument))
+                    apply(prms, options, setting.first, setting.second);
+            }
+        }
+        checkParameters(prms);
+    }
+
+
+    // set by SIGINT and SIGTERM, single runs and campaigns stop at the next chunk with a checkpoint
+    std::atomic<bool> interrupted {false};
+    JobScheduler* campaign = nullptr;
+
+    void interrupt(int)
+    {
+        interrupted.store(true);
+        if( campaign != nullptr )
+            campaign->stop();
+    }
+
+
+    void catchInterrupts()
+    {
+        // sweeps and replica exchange keep the default handlers and simply end
+        std::signal(SIGINT, interrupt);
+        std::signal(SIGTERM, interrupt);
+    }
+
+
+    std::vector<double> sweepValues(const RunOptions& options)
+    {
+        return sweepRange(options.start, options.step, options.stop);
+    }
+
+
+    bool runSingle(const Parameters& _prms, const RunOptions& options)
+    {
+        // equilibration and production like the "equilibrate" and "production" buttons,
+        // returns false if interrupted
+
+        catchInterrupts();
+
+        const std::string checkpoint = outputFile(_prms, "checkpoint");
+        MonteCarloHost MC;
+        if( options.resume && enhance::fileExists(checkpoint) )
+        {
+            MC.load_checkpoint(checkpoint);
+            std::cout << "resumed from " << checkpoint << "\n";
+        }
+        else
+        {
+            MC.setParameters(_prms);
+            MC.setup();
+        }
+        MC.setCheckpointFile(checkpoint);
+        MC.setTrajectoryFile(outputFile(MC.getParameters(), "trajectory"));
+
+        const Parameters& prms = MC.getParameters();
+        for(const bool equilibration : { true, false })
+        {
+            const unsigned long steps = equilibration ? prms.stepsEquil : prms.stepsProd;
+            while( MC.getStepsDone(equilibration) < steps )
+            {
+                if( interrupted.load() )
+                {
+                    MC.save_checkpoint(checkpoint);
+                    std::cout << "interrupted, continue with --resume from " << checkpoint << "\n";
+                    return false;
+                }
+                MC.run(prms.printFreq, equilibration);
+            }
+        }
+
+        MC.print_data();
+        MC.print_averages();
+        std::remove(checkpoint.c_str());
+
+        // enough to size stepsProd: about 2*tau_int samples make one independent one
+        const auto& energy = MC.getEnergyStatistics();
+        const auto& magnetisation = MC.getMagnetisationStatistics();
+        std::cout << "tau_int H = " << energy.getTau() << ", M = " << magnetisation.getTau() << " samples of " << prms.printFreq << " steps, "
+                  << ( energy.isConverged() && magnetisation.isConverged() ? "errors converged" : "errors not converged, increase stepsProd" ) << "\n";
+        return true;
+    }
+
+
+    void runSweep(const Parameters& prms, const RunOptions& options)
+    {
+        std::vector<Parameters> points;
+        for(const double value : sweepValues(options))
+        {
+            points.push_back(prms);
+            if( options.vary == "T" )       points.back().temperature = value;
+            else if( options.vary == "J" )  points.back().interaction = value;
+            else                            points.back().magnetic = value;
+            checkParameters(points.back());
+        }
+
+        SweepExecutor sweep;
+        sweep.setup(points);
+        sweep.run();
+        sweep.print_averages();
+    }
+
+
+    bool runCampaign(const RunOptions& options)
+    {
+        // settings of the command line override the ones of the job file,
+        // returns false if runs failed or were interrupted
+
+        JobScheduler scheduler;
+        campaign = &scheduler;
+        catchInterrupts();
+        scheduler.read(options.jobfile);
+        if( options.workers != 0 )
+            scheduler.setWorkers(options.workers);
+        if( options.memory != 0 )
+            scheduler.setMemoryLimit(options.memory << 20);
+        if( options.seeded )
+            scheduler.setSeed(options.seed);
+        scheduler.resume(options.journal.empty() ? options.jobfile + ".journal" : options.journal);
+        const bool complete = scheduler.run(std::cout);
+        campaign = nullptr;
+        return complete;
+    }
+
+
+    void convertData(const std::string& filename)
+    {
+        // binary columns back to the text layout of print_data
+
+        Parameters prms;
+        std::vector<double> energies;
+        std::vector<double> magnetisations;
+        ColumnarData::read(filename, prms, energies, magnetisations);
+
+        const std::string extension = ".bdata";
+        std::string target = filename;
+        if( target.size() > extension.size() && target.compare(target.size() - extension.size(), extension.size(), extension) == 0 )
+            target.erase(target.size() - extension.size());
+        target.append(".data");
+
+        std::ofstream FILE(target);
+        MonteCarloHost::print_data(FILE, prms, energies, magnetisations);
+        if( ! FILE )
+            throw std::runtime_error("cannot write " + target);
+        std::cout << energies.size() << " samples written to " << target << "\n";
+    }
+
+
+    void runReplicaExchange(const Parameters& prms, const RunOptions& options)
+    {
+        if( options.vary != "T" )
+            throw std::invalid_argument("replica exchange needs vary = T");
+
+        ReplicaExchange replicas;
+        replicas.setup(prms, sweepValues(options));
+        for(unsigned long done = 0; done < prms.stepsEquil; done += prms.printFreq)
+            replicas.run(prms.printFreq, true);
+        for(unsigned long done = 0; done < prms.stepsProd; done += prms.printFreq)
+            replicas.run(prms.printFreq, false);
+        replicas.print_averages();
+    }
+}
+
+
+
+int main(int argc, char* argv[])
+{
+    Parameters prms;
+    RunOptions options;
+
+    try
+    {
+        for(int i=1; i<argc; ++i)
+        {
+            if( std::string(argv[i]) == "--help" || std::string(argv[i]) == "-h" )
+            {
+                usage(std::cout);
+                return 0;
+            }
+        }
+        parse(argc, argv, prms, options);
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << "ising-cli: " << e.what() << "\n"
+                  << "see ising-cli --help\n";
+        return 1;
+    }
+
+    Logger::getInstance().write_new_line( "[GENERAL]" , "ISING LOG FILE (command line)");
+
+    if( ! options.convert.empty() )
+    {
+        try
+        {
+            convertData(options.convert);
+        }
+        catch(const std::exception& e)
+        {
+            std::cerr << "ising-cli: " << e.what() << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    if( ! options.jobfile.empty() )
+    {
+        try
+        {
+            return runCampaign(options) ? 0 : 1;
+        }
+        catch(const std::exception& e)
+        {
+            std::cerr << "ising-cli: " << e.what() << "\n";
+            return 1;
+        }
+    }
+
+    enhance::seed = options.seeded ? options.seed : std::random_device{}();
+    enhance::rand_engine.seed(enhance::seed);
+    Logger::getInstance().write_new_line("[GENERAL]", "seed for random number generator:", enhance::seed);
+
+    try
+    {
+        if( options.vary.empty() )
+        {
+            if( ! runSingle(prms, options) )
+                return 1;
+        }
+        else if( options.replicaExchange )
+            runReplicaExchange(prms, options);
+        else
+            runSweep(prms, options);
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << "ising-cli: " << e.what() << "\n";
+        return 1;
+    }
+
+    std::cout << "seed " << enhance::seed << ", output written to " << prms.fileKey << ".*\n";
+    return 0;
+}
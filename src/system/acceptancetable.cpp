@@ -0,0 +1,96 @@
+#include "acceptancetable.hpp"
+#include <cmath>
+
+
+
+constexpr int AcceptanceTable::maxInteractionChange;
+constexpr int AcceptanceTable::maxMagneticChange;
+constexpr std::uint64_t AcceptanceTable::always;
+
+
+
+void AcceptanceTable::update(const double J, const double B, const double T, const DYNAMICS rule)
+{
+    // recompute thresholds only if a parameter has changed
+
+    if( J == interaction && B == magnetic && T == temperature && rule == dynamics )
+        return;
+
+    interaction = J;
+    magnetic = B;
+    temperature = T;
+    dynamics = rule;
+    recompute();
+}
+
+
+
+std::uint64_t AcceptanceTable::scale(const double p)
+{
+    // p * 2^64, values rounding up to 2^64 are accepted always
+
+    const double scaled = std::ldexp(p, 64);
+    return p >= 1.0 || scaled >= std::ldexp(1.0, 64) ? always : static_cast<std::uint64_t>(scaled);
+}
+
+
+
+void AcceptanceTable::recompute()
+{
+    for(int dI = -maxInteractionChange; dI <= maxInteractionChange; ++dI)
+    for(int dM = -maxMagneticChange; dM <= maxMagneticChange; dM += 2)
+    {
+        thresholds[index(dI, dM)] = scale(probability(dI, dM));
+        weights[index(dI, dM)] = boltzmannWeight(dI, dM);
+    }
+
+    for(int neighbourSum = -4; neighbourSum <= 4; ++neighbourSum)
+    {
+        upThresholds[neighbourSum + 4] = scale(upProbability(neighbourSum));
+    }
+}
+
+
+
+double AcceptanceTable::probability(const int interactionChange, const int magneticChange) const
+{
+    // Metropolis criterion min(1, exp(-dH/T)) or heat-bath probability 1/(1+exp(dH/T))
+
+    const double energyChange = - interaction * interactionChange - magnetic * magneticChange;
+    if( dynamics == DYNAMICS::HEATBATH )
+    {
+        if( temperature <= 0 )
+            return energyChange < 0 ? 1.0 : ( energyChange > 0 ? 0.0 : 0.5 );
+        return 1.0 / (1.0 + std::exp(energyChange/temperature));
+    }
+
+    if( energyChange <= 0 )
+        return 1.0;
+    if( temperature <= 0 )
+        return 0.0;
+    return std::exp(-energyChange/temperature);
+}
+
+
+
+double AcceptanceTable::boltzmannWeight(const int interactionChange, const int magneticChange) const
+{
+    // exp(-dH/T), infinite for downhill moves at zero temperature
+
+    const double energyChange = - interaction * interactionChange - magnetic * magneticChange;
+    if( temperature <= 0 )
+        return energyChange < 0 ? std::numeric_limits<double>::infinity() : ( energyChange > 0 ? 0.0 : 1.0 );
+    return std::exp(-energyChange/temperature);
+}
+
+
+
+double AcceptanceTable::upProbability(const int neighbourSum) const
+{
+    // heat-bath probability of an up spin in the local field h = J sum_j s_j + B
+
+    const double field = interaction * neighbourSum + magnetic;
+    if( temperature <= 0 )
+        return field > 0 ? 1.0 : ( field < 0 ? 0.0 : 0.5 );
+    return 1.0 / (1.0 + std::exp(-2.0*field/temperature));
+}
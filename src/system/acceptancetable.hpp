@@ -0,0 +1,128 @@
+#pragma once
+
+#include "parameters.hpp"
+#include "lib/enhance.hpp"
+#include <array>
+#include <cstdint>
+#include <cassert>
+#include <limits>
+#include <cmath>
+
+
+
+// Precomputed Metropolis or heat-bath acceptance probabilities.
+// For nearest-neighbour Ising systems a move changes the Hamiltonian
+// H = -J sum_<ij> s_i s_j - B sum_i s_i  by  dH = -J*dI - B*dM, where the change
+// of the interaction sum dI and of the spin sum dM are small integers.
+// All possible probabilities are stored as thresholds which are compared
+// directly to the raw output of the random number engine.
+// For heat-bath updates the probability of an up spin is stored for every
+// sum of neighbour spins as well.
+// Moves with a proposal ratio (Hastings correction) use the Boltzmann
+// weights exp(-dH/T) instead, which are precomputed in the same way.
+class AcceptanceTable
+{
+public:
+    static constexpr int maxInteractionChange = 16;     // |dI| of any single move
+    static constexpr int maxMagneticChange = 2;         // |dM| of any single move
+    static constexpr std::uint64_t always = std::numeric_limits<std::uint64_t>::max();
+
+private:
+    double interaction {std::numeric_limits<double>::quiet_NaN()};
+    double magnetic    {std::numeric_limits<double>::quiet_NaN()};
+    double temperature {std::numeric_limits<double>::quiet_NaN()};
+    DYNAMICS dynamics {DYNAMICS::METROPOLIS};
+
+    std::array<std::uint64_t, (2*maxInteractionChange+1) * (maxMagneticChange+1)> thresholds {};
+    std::array<std::uint64_t, 9> upThresholds {};      // sum_j s_j = -4 ... 4
+    std::array<double, (2*maxInteractionChange+1) * (maxMagneticChange+1)> weights {};
+
+    static inline std::size_t index(const int, const int);
+
+public:
+    static std::uint64_t scale(const double);      // probability as threshold, see above
+
+    void update(const double, const double, const double, const DYNAMICS);     // J, B, T, dynamics
+    void recompute();
+
+    double probability(const int, const int) const;
+    double upProbability(const int) const;
+    double boltzmannWeight(const int, const int) const;
+    inline double weight(const int, const int) const;             // exp(-dH/T) looked up in the table
+    inline std::uint64_t threshold(const int, const int) const;   // accept if random number < threshold
+    template<typename ENGINE>
+    inline bool accept(const int, const int, ENGINE&) const;
+
+    template<typename ENGINE>
+    inline bool acceptRatio(const double, ENGINE&) const;    // accept for a ratio of weights times proposal ratio
+
+    template<typename ENGINE>
+    inline int heatBath(const int, ENGINE&) const;     // new spin for a sum of neighbour spins
+};
+
+
+
+inline std::size_t AcceptanceTable::index(const int interactionChange, const int magneticChange)
+{
+    assert( interactionChange >= -maxInteractionChange && interactionChange <= maxInteractionChange );
+    assert( magneticChange == -2 || magneticChange == 0 || magneticChange == 2 );
+
+    return (interactionChange + maxInteractionChange) * (maxMagneticChange+1) + (magneticChange + maxMagneticChange)/2;
+}
+
+
+
+inline std::uint64_t AcceptanceTable::threshold(const int interactionChange, const int magneticChange) const
+{
+    // threshold == always means accepted without drawing a random number
+
+    return thresholds[index(interactionChange, magneticChange)];
+}
+
+
+
+template<typename ENGINE>
+inline bool AcceptanceTable::accept(const int interactionChange, const int magneticChange, ENGINE& engine) const
+{
+    // downhill moves are accepted without drawing a random number
+
+    static_assert( ENGINE::min() == 0 && ENGINE::max() == always, "engine has to cover the full 64 bit range" );
+
+    const std::uint64_t threshold = thresholds[index(interactionChange, magneticChange)];
+    return threshold == always || engine() < threshold;
+}
+
+
+
+inline double AcceptanceTable::weight(const int interactionChange, const int magneticChange) const
+{
+    return weights[index(interactionChange, magneticChange)];
+}
+
+
+
+template<typename ENGINE>
+inline bool AcceptanceTable::acceptRatio(const double ratio, ENGINE& engine) const
+{
+    // Metropolis-Hastings min(1, R) or heat-bath R/(1+R), compared to a uniform number in [0,1)
+
+    static_assert( ENGINE::min() == 0 && ENGINE::max() == always, "engine has to cover the full 64 bit range" );
+
+    const double p = ( dynamics == DYNAMICS::HEATBATH ? ( std::isinf(ratio) ? 1.0 : ratio / (1.0 + ratio) ) : ratio );
+    if( p >= 1.0 )
+        return true;
+    return enhance::canonical(engine) < p;
+}
+
+
+
+template<typename ENGINE>
+inline int AcceptanceTable::heatBath(const int neighbourSum, ENGINE& engine) const
+{
+    // draw the new spin from the heat-bath probability of an up spin
+
+    assert( neighbourSum >= -4 && neighbourSum <= 4 );
+
+    const std::uint64_t threshold = upThresholds[neighbourSum + 4];
+    return threshold == always || engine() < threshold ? +1 : -1;
+}
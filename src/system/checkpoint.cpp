@@ -0,0 +1,163 @@
+#include "checkpoint.hpp"
+#include <fstream>
+#include <iterator>
+#include <cstdio>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+
+constexpr char Checkpoint::magic[9];
+constexpr std::uint32_t Checkpoint::version;
+constexpr std::uint32_t Checkpoint::byteOrder;
+
+
+
+std::uint64_t Checkpoint::checksum(const std::string& data)
+{
+    // 64 bit FNV-1a
+
+    std::uint64_t value = 0xcbf29ce484222325;
+    for(const char c : data)
+    {
+        value ^= static_cast<unsigned char>(c);
+        value *= 0x100000001b3;
+    }
+    return value;
+}
+
+
+
+void Checkpoint::write(const std::string& filename, const std::string& state)
+{
+    // write a temporary file, flush it to the disk and rename it over the old checkpoint
+
+    BinaryWriter file;
+    for(unsigned int i=0; i<8; ++i)
+        file.write(magic[i]);
+    file.write(version);
+    file.write(byteOrder);
+    file.write<std::uint64_t>(state.size());
+    std::string data = file.data();
+    data.append(state);
+    BinaryWriter tail;
+    tail.write(checksum(state));
+    data.append(tail.data());
+
+    const std::string temporary = filename + ".tmp";
+    const int descriptor = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if( descriptor < 0 )
+        throw std::runtime_error("cannot write " + temporary + ": " + std::strerror(errno));
+
+    std::size_t written = 0;
+    while( written < data.size() )
+    {
+        const auto result = ::write(descriptor, data.data() + written, data.size() - written);
+        if( result < 0 && errno == EINTR )
+            continue;
+        if( result <= 0 )
+        {
+            const std::string reason = std::strerror(errno);
+            ::close(descriptor);
+            std::remove(temporary.c_str());
+            throw std::runtime_error("cannot write " + temporary + ": " + reason);
+        }
+        written += static_cast<std::size_t>(result);
+    }
+
+    if( ::fsync(descriptor) != 0 || ::close(descriptor) != 0 || std::rename(temporary.c_str(), filename.c_str()) != 0 )
+    {
+        const std::string reason = std::strerror(errno);
+        std::remove(temporary.c_str());
+        throw std::runtime_error("cannot write " + filename + ": " + reason);
+    }
+}
+
+
+
+std::string Checkpoint::read(const std::string& filename)
+{
+    // the state written by write(), after all checks
+
+    std::ifstream FILE(filename, std::ios::binary);
+    if( ! FILE.is_open() )
+        throw std::runtime_error("cannot open " + filename);
+    const std::string data((std::istreambuf_iterator<char>(FILE)), std::istreambuf_iterator<char>());
+
+    BinaryReader file(data);
+    char fileMagic[8] {};
+    for(auto& c : fileMagic)
+        file.read(c);
+    if( std::memcmp(fileMagic, magic, 8) != 0 )
+        throw std::runtime_error(filename + " is no checkpoint");
+    if( file.get<std::uint32_t>() != version )
+        throw std::runtime_error(filename + " has an unknown checkpoint version");
+    if( file.get<std::uint32_t>() != byteOrder )
+        throw std::runtime_error(filename + " was written with a different byte order");
+
+    const auto size = file.get<std::uint64_t>();
+    const std::size_t header = 8 + 2*sizeof(std::uint32_t) + sizeof(std::uint64_t);
+    if( data.size() != header + size + sizeof(std::uint64_t) )
+        throw std::runtime_error(filename + " is truncated");
+
+    std::string state = data.substr(header, size);
+    std::uint64_t expected = 0;
+    std::memcpy(&expected, data.data() + header + size, sizeof(expected));
+    if( checksum(state) != expected )
+        throw std::runtime_error(filename + " is corrupted");
+    return state;
+}
+
+
+
+void Checkpoint::save(BinaryWriter& out, const Parameters& prms)
+{
+    out.write(prms.width);
+    out.write(prms.height);
+    out.write(prms.interaction);
+    out.write(prms.magnetic);
+    out.write(prms.temperature);
+    out.write(prms.constrained);
+    out.write(prms.ratio);
+    out.write(prms.wavelengthPattern);
+    out.write(prms.wavelength);
+    out.write(prms.scheme);
+    out.write(prms.dynamics);
+    out.write(prms.threads);
+    out.write(prms.stepsEquil);
+    out.write(prms.stepsProd);
+    out.write(prms.printFreq);
+    out.write(prms.checkpointInterval);
+    out.write(prms.trajectoryInterval);
+    out.write(prms.recordSamples);
+    out.write(prms.fileKey);
+    out.write(prms.dataFormat);
+}
+
+
+
+void Checkpoint::load(BinaryReader& in, Parameters& prms)
+{
+    in.read(prms.width);
+    in.read(prms.height);
+    in.read(prms.interaction);
+    in.read(prms.magnetic);
+    in.read(prms.temperature);
+    in.read(prms.constrained);
+    in.read(prms.ratio);
+    in.read(prms.wavelengthPattern);
+    in.read(prms.wavelength);
+    in.read(prms.scheme);
+    in.read(prms.dynamics);
+    in.read(prms.threads);
+    in.read(prms.stepsEquil);
+    in.read(prms.stepsProd);
+    in.read(prms.printFreq);
+    in.read(prms.checkpointInterval);
+    in.read(prms.trajectoryInterval);
+    in.read(prms.recordSamples);
+    in.read(prms.fileKey);
+    in.read(prms.dataFormat);
+}
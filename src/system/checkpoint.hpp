@@ -0,0 +1,29 @@
+#pragma once
+
+#include "parameters.hpp"
+#include "utility/binarystream.hpp"
+#include <string>
+#include <cstdint>
+
+
+
+// Checkpoint files of a MonteCarloHost: a short header (magic, version, byte order, size),
+// the binary state written by the host and a checksum of it.
+// Files are replaced atomically, a crash while writing leaves the previous checkpoint intact.
+// Broken, foreign or truncated files throw std::runtime_error when read.
+class Checkpoint
+{
+private:
+    static constexpr char magic[9] = "ISINGCKP";
+    static constexpr std::uint32_t version = 5;
+    static constexpr std::uint32_t byteOrder = 0x01020304;
+
+    static std::uint64_t checksum(const std::string&);
+
+public:
+    static void write(const std::string&, const std::string&);    // file, state
+    static std::string read(const std::string&);
+
+    static void save(BinaryWriter&, const Parameters&);
+    static void load(BinaryReader&, Parameters&);
+};
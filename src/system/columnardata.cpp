@@ -0,0 +1,270 @@
+#include "columnardata.hpp"
+#include "utility/binarystream.hpp"
+#include <fstream>
+#include <iterator>
+#include <cstring>
+#include <stdexcept>
+
+
+
+constexpr char ColumnarData::magic[9];
+constexpr std::uint32_t ColumnarData::version;
+constexpr std::uint32_t ColumnarData::byteOrder;
+
+
+
+namespace
+{
+    // bits are filled in from the most significant end of every byte
+    class BitWriter
+    {
+    private:
+        std::string bytes {};
+        unsigned int used {8};      // bits used in the last byte
+
+    public:
+        void put(const std::uint64_t value, unsigned int bits)
+        {
+            while( bits > 0 )
+            {
+                if( used == 8 )
+                {
+                    bytes.push_back(0);
+                    used = 0;
+                }
+                const unsigned int take = std::min(bits, 8 - used);
+                const unsigned int part = static_cast<unsigned int>( (value >> (bits - take)) & ((1u << take) - 1) );
+                bytes.back() = static_cast<char>( static_cast<unsigned char>(bytes.back()) | (part << (8 - used - take)) );
+                used += take;
+                bits -= take;
+            }
+        }
+
+        inline const std::string& data() const { return bytes; }
+    };
+
+
+    class BitReader
+    {
+    private:
+        const std::string& bytes;
+        std::size_t position {0};   // in bits
+
+    public:
+        explicit BitReader(const std::string& _bytes) : bytes(_bytes) {}
+
+        std::uint64_t get(unsigned int bits)
+        {
+            if( bits > 8 * bytes.size() - position )
+                throw std::runtime_error("compressed column ends unexpectedly");
+
+            std::uint64_t value = 0;
+            while( bits > 0 )
+            {
+                const unsigned int offset = position % 8;
+                const unsigned int take = std::min(bits, 8 - offset);
+                const unsigned int byte = static_cast<unsigned char>(bytes[position / 8]);
+                value = (value << take) | ( (byte >> (8 - offset - take)) & ((1u << take) - 1) );
+                position += take;
+                bits -= take;
+            }
+            return value;
+        }
+    };
+
+
+    // the parameters of a data file, kept apart from the checkpoint layout so that
+    // checkpoint changes leave the data format alone; new fields go to the end
+    void writeHeader(BinaryWriter& out, const Parameters& prms)
+    {
+        out.write(prms.width);
+        out.write(prms.height);
+        out.write(prms.interaction);
+        out.write(prms.magnetic);
+        out.write(prms.temperature);
+        out.write(prms.constrained);
+        out.write(prms.ratio);
+        out.write(prms.wavelengthPattern);
+        out.write(prms.wavelength);
+        out.write(prms.scheme);
+        out.write(prms.dynamics);
+        out.write(prms.threads);
+        out.write(prms.stepsEquil);
+        out.write(prms.stepsProd);
+        out.write(prms.printFreq);
+        out.write(prms.checkpointInterval);
+        out.write(prms.trajectoryInterval);
+        out.write(prms.fileKey);
+        out.write(prms.dataFormat);
+    }
+
+
+    void readHeader(BinaryReader& in, Parameters& prms)
+    {
+        in.read(prms.width);
+        in.read(prms.height);
+        in.read(prms.interaction);
+        in.read(prms.magnetic);
+        in.read(prms.temperature);
+        in.read(prms.constrained);
+        in.read(prms.ratio);
+        in.read(prms.wavelengthPattern);
+        in.read(prms.wavelength);
+        in.read(prms.scheme);
+        in.read(prms.dynamics);
+        in.read(prms.threads);
+        in.read(prms.stepsEquil);
+        in.read(prms.stepsProd);
+        in.read(prms.printFreq);
+        in.read(prms.checkpointInterval);
+        in.read(prms.trajectoryInterval);
+        in.read(prms.fileKey);
+        in.read(prms.dataFormat);
+    }
+}
+
+
+
+std::string ColumnarData::encode(const std::vector<double>& values)
+{
+    // per value:  0                      same as the one before
+    //             10 <bits>              XOR fits into the window of leading and trailing zeros used last
+    //             11 <6> <6> <bits>      new window: leading zeros, number of bits - 1, the bits
+
+    BitWriter out;
+    std::uint64_t previous = 0;
+    unsigned int leading = 64;
+    unsigned int trailing = 0;
+
+    for(const double value : values)
+    {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        const std::uint64_t change = bits ^ previous;
+        previous = bits;
+
+        if( change == 0 )
+        {
+            out.put(0, 1);
+            continue;
+        }
+
+        const unsigned int zerosBefore = __builtin_clzll(change);
+        const unsigned int zerosAfter = __builtin_ctzll(change);
+        if( leading < 64 && zerosBefore >= leading && zerosAfter >= trailing )
+        {
+            out.put(0b10, 2);
+            out.put(change >> trailing, 64 - leading - trailing);
+        }
+        else
+        {
+            leading = zerosBefore;
+            trailing = zerosAfter;
+            const unsigned int length = 64 - leading - trailing;
+            out.put(0b11, 2);
+            out.put(leading, 6);
+            out.put(length - 1, 6);
+            out.put(change >> trailing, length);
+        }
+    }
+    return out.data();
+}
+
+
+
+std::vector<double> ColumnarData::decode(const std::string& column, const std::size_t count)
+{
+    BitReader in(column);
+    std::vector<double> values(count);
+    std::uint64_t previous = 0;
+    unsigned int leading = 64;
+    unsigned int trailing = 0;
+
+    for(auto& value : values)
+    {
+        if( in.get(1) == 1 )
+        {
+            if( in.get(1) == 1 )
+            {
+                leading = static_cast<unsigned int>(in.get(6));
+                const unsigned int length = static_cast<unsigned int>(in.get(6)) + 1;
+                if( leading + length > 64 )
+                    throw std::runtime_error("compressed column is corrupted");
+                trailing = 64 - leading - length;
+            }
+            else if( leading == 64 )
+            {
+                throw std::runtime_error("compressed column is corrupted");
+            }
+            previous ^= in.get(64 - leading - trailing) << trailing;
+        }
+        std::memcpy(&value, &previous, sizeof(value));
+    }
+    return values;
+}
+
+
+
+void ColumnarData::write(const std::string& filename, const Parameters& prms, const std::vector<double>& energies, const std::vector<double>& magnetisations)
+{
+    if( energies.size() != magnetisations.size() )
+        throw std::invalid_argument("columns of different length");
+
+    BinaryWriter out;
+    for(unsigned int i=0; i<8; ++i)
+        out.write(magic[i]);
+    out.write(version);
+    out.write(byteOrder);
+    BinaryWriter header;
+    writeHeader(header, prms);
+    out.write(header.data());
+    out.write<std::uint64_t>(energies.size());
+    out.write(encode(energies));
+    out.write(encode(magnetisations));
+
+    std::ofstream FILE(filename, std::ios::binary);
+    FILE.write(out.data().data(), out.data().size());
+    if( ! FILE )
+        throw std::runtime_error("cannot write " + filename);
+}
+
+
+
+void ColumnarData::read(const std::string& filename, Parameters& prms, std::vector<double>& energies, std::vector<double>& magnetisations)
+{
+    std::ifstream FILE(filename, std::ios::binary);
+    if( ! FILE.is_open() )
+        throw std::runtime_error("cannot open " + filename);
+    const std::string data((std::istreambuf_iterator<char>(FILE)), std::istreambuf_iterator<char>());
+
+    BinaryReader in(data);
+    char fileMagic[8] {};
+    for(auto& c : fileMagic)
+        in.read(c);
+    if( std::memcmp(fileMagic, magic, 8) != 0 )
+        throw std::runtime_error(filename + " is no binary data file");
+    const auto fileVersion = in.get<std::uint32_t>();
+    if( fileVersion == 0 || fileVersion > version )
+        throw std::runtime_error(filename + " has an unknown data format version");
+    if( in.get<std::uint32_t>() != byteOrder )
+        throw std::runtime_error(filename + " was written with a different byte order");
+
+    // version 1 has the same fields without the length in front
+    if( fileVersion == 1 )
+    {
+        readHeader(in, prms);
+    }
+    else
+    {
+        std::string header;
+        in.read(header);
+        BinaryReader fields(header);
+        readHeader(fields, prms);
+    }
+    const auto samples = in.get<std::uint64_t>();
+    std::string column;
+    in.read(column);
+    energies = decode(column, samples);
+    in.read(column);
+    magnetisations = decode(column, samples);
+}
@@ -0,0 +1,76 @@
+#include "interfacebonds.hpp"
+
+
+
+constexpr unsigned int InterfaceBonds::none;
+
+
+
+void InterfaceBonds::rebuild(const Lattice& lattice)
+{
+    // collect all anti-aligned bonds of the lattice
+
+    bonds.clear();
+    bonds.reserve(2 * lattice.size());
+    positions.assign(2 * lattice.size(), none);
+    for(unsigned int bond=0; bond<2*lattice.size(); ++bond)
+        check(lattice, bond);
+}
+
+
+
+void InterfaceBonds::clear()
+{
+    bonds.clear();
+    bonds.shrink_to_fit();
+    positions.clear();
+    positions.shrink_to_fit();
+}
+
+
+
+void InterfaceBonds::update(const Lattice& lattice, const unsigned int id)
+{
+    // bonds to the right and below belong to the spin itself,
+    // bonds to the left and above belong to the neighbours there
+
+    assert( positions.size() == 2 * lattice.size() );
+
+    const auto N = lattice.getNeighbours(id);   // up, right, below, left
+    check(lattice, 2*id);
+    check(lattice, 2*id + 1);
+    check(lattice, 2*N[3]);
+    check(lattice, 2*N[0] + 1);
+}
+
+
+
+void InterfaceBonds::save(BinaryWriter& out) const
+{
+    out.write<std::uint8_t>( ! positions.empty() );
+    out.write(bonds);
+    out.write<std::uint64_t>(positions.size());
+}
+
+
+
+void InterfaceBonds::load(BinaryReader& in)
+{
+    // positions follow from the order of the bonds
+
+    const bool kept = in.get<std::uint8_t>();
+    in.read(bonds);
+    const auto size = in.get<std::uint64_t>();
+    if( ! kept )
+    {
+        clear();
+        return;
+    }
+    positions.assign(size, none);
+    for(unsigned int position=0; position<bonds.size(); ++position)
+    {
+        if( bonds[position] >= size )
+            throw std::runtime_error("interface bond out of range");
+        positions[bonds[position]] = position;
+    }
+}
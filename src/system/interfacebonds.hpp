@@ -0,0 +1,94 @@
+#pragma once
+
+#include "lattice.hpp"
+#include "utility/binarystream.hpp"
+#include <vector>
+#include <limits>
+#include <cassert>
+
+
+
+// Set of all bonds between opposite spins (the interface) for spin-exchange moves.
+// Bond 2*id connects spin id with its right neighbour, bond 2*id+1 with the one below,
+// so every bond of the Hamiltonian appears once. Insertion, removal and drawing
+// a random bond take O(1), after an exchange only the bonds of the two spins change.
+class InterfaceBonds
+{
+private:
+    static constexpr unsigned int none = std::numeric_limits<unsigned int>::max();
+
+    std::vector<unsigned int> bonds {};       // all anti-aligned bonds in arbitrary order
+    std::vector<unsigned int> positions {};   // position of every bond in bonds, none if aligned
+
+    inline void insert(const unsigned int);
+    inline void erase(const unsigned int);
+    inline void check(const Lattice&, const unsigned int);
+
+public:
+    void rebuild(const Lattice&);
+    void clear();
+    void update(const Lattice&, const unsigned int);     // re-check the four bonds of a spin
+
+    // the order of the bonds decides which one is drawn, so it is kept as it is
+    void save(BinaryWriter&) const;
+    void load(BinaryReader&);
+
+    inline auto size() const { return bonds.size(); }
+    inline unsigned int getBond(const unsigned int index) const { return bonds[index]; }
+    static inline unsigned int first(const Lattice&, const unsigned int);
+    static inline unsigned int second(const Lattice&, const unsigned int);
+};
+
+
+
+inline unsigned int InterfaceBonds::first(const Lattice&, const unsigned int bond)
+{
+    return bond / 2;
+}
+
+
+
+inline unsigned int InterfaceBonds::second(const Lattice& lattice, const unsigned int bond)
+{
+    // right (index 1) or below (index 2) neighbour of the first spin
+    return lattice.getNeighbours(bond / 2)[1 + bond % 2];
+}
+
+
+
+inline void InterfaceBonds::insert(const unsigned int bond)
+{
+    if( positions[bond] != none )
+        return;
+    positions[bond] = bonds.size();
+    bonds.push_back(bond);
+}
+
+
+
+inline void InterfaceBonds::erase(const unsigned int bond)
+{
+    // move the last bond into the gap
+
+    const unsigned int position = positions[bond];
+    if( position == none )
+        return;
+    bonds[position] = bonds.back();
+    positions[bonds[position]] = position;
+    bonds.pop_back();
+    positions[bond] = none;
+}
+
+
+
+inline void InterfaceBonds::check(const Lattice& lattice, const unsigned int bond)
+{
+    // links of a spin to itself never enter the set
+
+    const unsigned int id = first(lattice, bond);
+    const unsigned int neighbour = second(lattice, bond);
+    if( id != neighbour && lattice.getType(id) != lattice.getType(neighbour) )
+        insert(bond);
+    else
+        erase(bond);
+}
@@ -0,0 +1,489 @@
+#include "jobscheduler.hpp"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <random>
+#include <cstdint>
+#include <limits>
+#include <cstdio>
+
+
+
+namespace
+{
+    std::vector<std::string> expand(const std::string& value)
+    {
+        // comma separated list, every item may be a range start:step:stop of numbers
+
+        std::vector<std::string> values;
+        std::istringstream list(value);
+        std::string item;
+        while( std::getline(list, item, ',') )
+        {
+            item = trim(item);
+            const auto first = item.find(':');
+            const auto second = item.find(':', first + 1);
+            if( first != std::string::npos && second != std::string::npos )
+            {
+                const auto range = sweepRange(toNumber<double>(item, item.substr(0, first)),
+                                              toNumber<double>(item, item.substr(first + 1, second - first - 1)),
+                                              toNumber<double>(item, item.substr(second + 1)));
+                for(const double number : range)
+                {
+                    std::ostringstream text;
+                    text << std::setprecision(std::numeric_limits<double>::max_digits10) << number;
+                    values.push_back(text.str());
+                }
+            }
+            else
+            {
+                values.push_back(item);
+            }
+        }
+        if( values.empty() )
+            values.emplace_back();
+        return values;
+    }
+
+
+    std::string hash(const std::string& text)
+    {
+        // 64 bit FNV-1a as hex digits
+
+        std::uint64_t value = 0xcbf29ce484222325;
+        for(const char c : text)
+        {
+            value ^= static_cast<unsigned char>(c);
+            value *= 0x100000001b3;
+        }
+        std::ostringstream digits;
+        digits << std::hex << std::setw(16) << std::setfill('0') << value;
+        return digits.str();
+    }
+}
+
+
+
+void JobScheduler::read(std::istream& stream)
+{
+    // settings before the first [job] are shared, every [job] expands to all combinations of its values
+
+    Settings globals;
+    std::vector<Settings> sections;
+    std::string line;
+    for(unsigned int number=1; std::getline(stream, line); ++number)
+    {
+        line = trim(line.substr(0, line.find('#')));
+        if( line.empty() )
+            continue;
+        if( line == "[job]" )
+        {
+            sections.emplace_back();
+            continue;
+        }
+
+        try
+        {
+            const auto setting = splitSetting(line);
+            if( ! sections.empty() )
+                sections.back().push_back(setting);
+            else if( setting.first == "workers" )
+                setWorkers(toNumber<unsigned int>(setting.first, setting.second));
+            else if( setting.first == "memory" )
+                setMemoryLimit(toNumber<std::size_t>(setting.first, setting.second) << 20);
+            else if( setting.first == "masterSeed" )
+                setSeed(toNumber<unsigned int>(setting.first, setting.second));
+            else
+                globals.push_back(setting);
+        }
+        catch(const std::invalid_argument& e)
+        {
+            throw std::invalid_argument("line " + std::to_string(number) + ": " + e.what());
+        }
+    }
+    if( sections.empty() )
+        sections.emplace_back();
+
+    jobs.clear();
+    for(const auto& section : sections)
+    {
+        Settings settings = globals;
+        settings.insert(settings.end(), section.begin(), section.end());
+
+        std::vector<std::vector<std::string>> values;
+        for(const auto& setting : settings)
+            values.push_back(expand(setting.second));
+
+        // all combinations, the first setting varies slowest
+        std::vector<std::size_t> choice(settings.size(), 0);
+        while( true )
+        {
+            Settings combination;
+            for(std::size_t i=0; i<settings.size(); ++i)
+                combination.emplace_back(settings[i].first, values[i][choice[i]]);
+            jobs.emplace_back();
+            jobs.back().index = jobs.size() - 1;
+            setupJob(jobs.back(), combination);
+
+            std::size_t i = settings.size();
+            while( i > 0 && ++choice[i-1] == values[i-1].size() )
+                choice[--i] = 0;
+            if( i == 0 )
+                break;
+        }
+    }
+
+    std::stable_sort(jobs.begin(), jobs.end(), [](const Job& a, const Job& b){ return a.cost > b.cost; });
+    Logger::getInstance().write_new_line("[jobs]", jobs.size(), "runs read");
+}
+
+
+
+void JobScheduler::read(const std::string& filename)
+{
+    std::ifstream FILE(filename);
+    if( ! FILE.is_open() )
+        throw std::invalid_argument("cannot open " + filename);
+    read(FILE);
+}
+
+
+
+void JobScheduler::setupJob(Job& job, const Settings& settings)
+{
+    // a run is the unit of parallelism, so it uses one thread unless more are asked for
+
+    job.seed = job.index + 1;
+    for(const auto& setting : settings)
+    {
+        if( setting.first == "seed" )
+            job.seed = toNumber<unsigned long>(setting.first, setting.second);
+        else if( ! setParameter(job.parameters, setting.first, setting.second) )
+            throw std::invalid_argument("unknown key " + setting.first);
+    }
+    checkParameters(job.parameters);
+    if( job.parameters.threads == 0 )
+        job.parameters.threads = 1;
+
+    job.cost = costEstimate(job.parameters);
+    job.memory = memoryEstimate(job.parameters);
+    job.cores = job.parameters.threads;
+
+    std::ostringstream text;
+    writeParameters(text, job.parameters);
+    text << "seed = " << job.seed << '\n';
+    job.key = std::to_string(job.index) + "-" + hash(text.str());
+}
+
+
+
+void JobScheduler::resume(const std::string& filename)
+{
+    // an existing journal brings its master seed and finished runs, a new one records the seed
+
+    journal = filename;
+    done.clear();
+
+    std::ifstream IN(filename);
+    if( IN.is_open() )
+    {
+        bool found = false;
+        std::string word;
+        while( IN >> word )
+        {
+            if( word == "seed" && IN >> masterSeed )
+                found = true;
+            else if( word == "done" && IN >> word )
+                done.insert(word);
+            else
+                IN.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        }
+        if( ! found )
+            throw std::invalid_argument("no seed in journal " + filename);
+        seeded = true;
+        Logger::getInstance().write_new_line("[jobs]", "resuming from", filename, "with", done.size(), "finished runs");
+    }
+    else
+    {
+        if( ! seeded )
+            masterSeed = std::random_device{}();
+        seeded = true;
+        std::ofstream OUT(filename);
+        if( ! OUT.is_open() )
+            throw std::invalid_argument("cannot write journal " + filename);
+        OUT << "# journal of finished runs, needed to resume the campaign\n"
+            << "seed " << masterSeed << '\n';
+    }
+
+    enhance::seed = masterSeed;
+    enhance::rand_engine.seed(enhance::seed);
+}
+
+
+
+bool JobScheduler::run(std::ostream& progress)
+{
+    // every worker takes the largest pending run that fits into the free cores and memory
+
+    if( ! seeded )
+        setSeed(std::random_device{}());
+    if( journal.empty() )
+    {
+        enhance::seed = masterSeed;
+        enhance::rand_engine.seed(enhance::seed);
+    }
+
+    const unsigned int cores = std::max(1u, workers == 0 ? std::thread::hardware_concurrency() : workers);
+
+    std::vector<const Job*> pending;
+    double totalCost = 0;
+    for(const auto& job : jobs)
+    {
+        if( done.count(job.key) == 0 )
+        {
+            pending.push_back(&job);
+            totalCost += job.cost;
+        }
+    }
+    const std::size_t total = pending.size();
+    std::size_t recorded = 0;               // only runs with results count as done work
+    double recordedCost = 0;
+    std::size_t interruptedRuns = 0;
+    std::vector<std::string> failures;
+
+    progress << total << " of " << jobs.size() << " runs to do on " << cores << " cores, seed " << enhance::seed << std::endl;
+    const auto start = std::chrono::steady_clock::now();
+
+    auto worker = [&]
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while( ! pending.empty() && ! stopping.load() )
+        {
+            // anything may start once nothing else runs, so oversized runs are not stuck
+            const auto next = std::find_if(pending.begin(), pending.end(), [&](const Job* job)
+            {
+                return running == 0 || ( coresInUse + std::min(job->cores, cores) <= cores
+                                      && ( memoryLimit == 0 || memoryInUse + job->memory <= memoryLimit ) );
+            });
+            if( next == pending.end() )
+            {
+                finished.wait(lock);
+                continue;
+            }
+
+            const Job& job = **next;
+            pending.erase(next);
+            coresInUse += std::min(job.cores, cores);
+            memoryInUse += job.memory;
+            ++running;
+            lock.unlock();
+
+            std::string failure;
+            bool interrupted = false;
+            try
+            {
+                interrupted = ! runJob(job);
+            }
+            catch(const std::exception& e)
+            {
+                failure = e.what();
+            }
+
+            lock.lock();
+            coresInUse -= std::min(job.cores, cores);
+            memoryInUse -= job.memory;
+            --running;
+            if( ! failure.empty() )
+            {
+                failures.push_back("run " + std::to_string(job.index) + ": " + failure);
+            }
+            else if( interrupted )
+            {
+                ++interruptedRuns;
+            }
+            else
+            {
+                ++recorded;
+                recordedCost += job.cost;
+            }
+
+            const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            const double fraction = totalCost > 0 ? recordedCost / totalCost : 1.0;
+            std::ostringstream report;
+            report << "[" << recorded << "/" << total << "] run " << job.index
+                   << " L=" << job.parameters.width << "x" << job.parameters.height
+                   << " J=" << job.parameters.interaction << " T=" << job.parameters.temperature << " B=" << job.parameters.magnetic
+                   << " " << toString(job.parameters.scheme) << " seed " << job.seed
+                   << ( ! failure.empty() ? " failed: " + failure : interrupted ? " interrupted, checkpoint written" : " done" )
+                   << ", " << std::fixed << std::setprecision(1) << 100.0 * fraction << "% of the work after " << elapsed << " s";
+            if( fraction > 0 && fraction < 1 )
+                report << ", about " << elapsed * (1.0 - fraction) / fraction << " s left";
+            progress << report.str() << std::endl;
+
+            finished.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for(unsigned int t=1; t<std::min<std::size_t>(cores, total); ++t)
+        threads.emplace_back(worker);
+    worker();
+    for(auto& thread : threads)
+        thread.join();
+
+    // failed runs are easy to miss between the progress lines
+    progress << recorded << " of " << total << " runs recorded";
+    if( interruptedRuns > 0 )
+        progress << ", " << interruptedRuns << " interrupted";
+    if( recorded + interruptedRuns + failures.size() < total )
+        progress << ", " << total - recorded - interruptedRuns - failures.size() << " not started";
+    if( ! failures.empty() )
+        progress << ", " << failures.size() << " failed:";
+    progress << std::endl;
+    for(const auto& failure : failures)
+        progress << "  " << failure << std::endl;
+    return recorded == total;
+}
+
+
+
+bool JobScheduler::runJob(const Job& job)
+{
+    // equilibration and production of a single run on its own random stream,
+    // continued from its checkpoint if there is one, returns false if stopped midway
+
+    const std::string checkpoint = outputFile(job.parameters, "checkpoint", job.key);
+    MonteCarloHost host(job.seed);
+    if( enhance::fileExists(checkpoint) )
+    {
+        host.load_checkpoint(checkpoint);
+    }
+    else
+    {
+        host.setParameters(job.parameters);
+        host.setup();
+    }
+    host.setCheckpointFile(checkpoint);
+    host.setTrajectoryFile(outputFile(job.parameters, "trajectory", job.key));
+
+    const Parameters& prms = host.getParameters();
+    for(const bool equilibration : { true, false })
+    {
+        const unsigned long steps = equilibration ? prms.stepsEquil : prms.stepsProd;
+        while( host.getStepsDone(equilibration) < steps )
+        {
+            if( stopping.load() )
+            {
+                host.save_checkpoint(checkpoint);
+                return false;
+            }
+            host.run(prms.printFreq, equilibration);
+        }
+    }
+
+    host.print_data(job.key);
+    std::ostringstream line;
+    host.print_averages(line);
+    record(job, line.str());
+    std::remove(checkpoint.c_str());
+    return true;
+}
+
+
+
+void JobScheduler::record(const Job& job, const std::string& line)
+{
+    // averages first, then the journal: an interruption in between repeats the run, it never loses it
+
+    std::lock_guard<std::mutex> lock(outputMutex);
+
+    std::string filekeystring = job.parameters.fileKey;
+    std::string filekey = filekeystring.substr( 0, filekeystring.find_first_of(" ") );
+    filekey.append(".averaged_data");
+
+    std::ofstream FILE;
+    if( ! enhance::fileExists(filekey) )
+    {
+        FILE.open(filekey);
+        MonteCarloHost::print_averages_header(FILE);
+    }
+    else
+    {
+        FILE.open(filekey, std::ios::app);
+    }
+    FILE << line;
+    FILE.close();
+
+    if( ! journal.empty() )
+    {
+        std::ofstream JOURNAL(journal, std::ios::app);
+        JOURNAL << "done " << job.key << '\n';
+    }
+
+    Logger::getInstance().write_new_line("[jobs]", "run", job.index, "finished");
+}
+
+
+
+void JobScheduler::stop()
+{
+    stopping.store(true);
+}
+
+
+
+void JobScheduler::setWorkers(const unsigned int _workers)
+{
+    workers = _workers;
+}
+
+
+
+void JobScheduler::setMemoryLimit(const std::size_t bytes)
+{
+    memoryLimit = bytes;
+}
+
+
+
+void JobScheduler::setSeed(const unsigned int seed)
+{
+    masterSeed = seed;
+    seeded = true;
+}
+
+
+
+double JobScheduler::costEstimate(const Parameters& prms)
+{
+    // spin updates: steps are single moves at random sites and in constrained mode, sweeps otherwise
+
+    const double steps = static_cast<double>(prms.stepsEquil) + prms.stepsProd;
+    if( prms.constrained || prms.scheme == UPDATESCHEME::RANDOM )
+        return steps;
+    return steps * prms.width * prms.height;
+}
+
+
+
+std::size_t JobScheduler::memoryEstimate(const Parameters& prms)
+{
+    // rough upper bound: spins with the helpers of the scheme plus the recorded samples, if they are kept
+
+    std::size_t perSpin = 1;
+    switch( prms.scheme )
+    {
+        case UPDATESCHEME::PERMUTATION :    perSpin += 4;   break;
+        case UPDATESCHEME::MULTISPIN :      perSpin += 8;   break;
+        case UPDATESCHEME::WOLFF :          perSpin += 8;   break;
+        case UPDATESCHEME::SWENDSENWANG :   perSpin += 10;  break;
+        case UPDATESCHEME::NFOLDWAY :       perSpin += 16;  break;
+        default :                           break;
+    }
+    if( prms.constrained )
+        perSpin += 16;
+
+    const std::size_t samples = prms.printFreq == 0 || ! prms.recordSamples ? 0 : prms.stepsProd / prms.printFreq + 1;
+    return static_cast<std::size_t>(prms.width) * prms.height * perSpin + samples * 2 * sizeof(double);
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "montecarlohost.hpp"
+#include "parameters.hpp"
+#include "parametersio.hpp"
+#include "lib/enhance.hpp"
+#include "utility/logger.hpp"
+#include <vector>
+#include <string>
+#include <set>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <istream>
+#include <ostream>
+
+
+
+// Campaign of many independent runs described by a job file:
+//
+//   # settings before the first [job] apply to every job
+//   scheme = checkerboard
+//   workers = 16                  cores to use, memory = limit in MB, masterSeed = seed of all streams
+//   [job]
+//   width = 32, 64                lists and start:step:stop ranges expand
+//   T = 2.0:0.1:2.5               to every combination of their values
+//   seed = 1, 2                   random stream of the run, the position in the file by default
+//
+// Runs start largest first (spin updates) whenever their cores and memory fit into the limits,
+// a run larger than the limits starts once nothing else is running. Every finished run appends its
+// averages to <fileKey>.averaged_data and is recorded in the journal. Started again with the same
+// job file and journal the recorded runs are skipped and the master seed of the journal is reused,
+// so an interrupted campaign ends with the same results. Every run keeps a checkpoint
+// <fileKey>.<key>.checkpoint (see checkpointInterval and stop()), a run interrupted midway
+// continues from it exactly where it was, the file is removed once the run is recorded.
+// The samples of a run go to <fileKey>.<key>.data (or .bdata) unless recordSamples is off,
+// lattice snapshots to <fileKey>.<key>.trajectory if trajectoryInterval is set.
+class JobScheduler
+{
+public:
+    struct Job
+    {
+        std::size_t   index {0};        // position in the expanded job file
+        Parameters    parameters {};
+        unsigned long seed {0};         // random stream of the master seed
+        double        cost {0};         // estimated spin updates
+        std::size_t   memory {0};       // estimated bytes
+        unsigned int  cores {1};
+        std::string   key {};           // identifies the run in the journal
+    };
+
+private:
+    std::vector<Job> jobs {};           // largest first
+    std::set<std::string> done {};      // keys of finished runs, from the journal
+    std::string   journal {};
+    unsigned int  workers {0};          // 0: all hardware threads
+    std::size_t   memoryLimit {0};      // 0: no limit
+    bool          seeded {false};
+    unsigned int  masterSeed {0};
+
+    // resources of the running jobs, guarded by mutex
+    std::mutex    mutex {};
+    std::condition_variable finished {};
+    unsigned int  coresInUse {0};
+    std::size_t   memoryInUse {0};
+    unsigned int  running {0};
+
+    std::mutex    outputMutex {};       // averaged data files and journal
+
+    std::atomic<bool> stopping {false};
+
+    void setupJob(Job&, const Settings&);
+    bool runJob(const Job&);
+    void record(const Job&, const std::string&);
+
+public:
+    void read(std::istream&);
+    void read(const std::string&);      // from a file
+    void resume(const std::string&);    // journal file, sets enhance::seed
+    bool run(std::ostream&);            // progress lines, false unless every run was recorded
+    void stop();                        // checkpoint the running jobs and start no more, safe in signal handlers
+
+    void setWorkers(const unsigned int);
+    void setMemoryLimit(const std::size_t);
+    void setSeed(const unsigned int);
+
+    static double      costEstimate(const Parameters&);
+    static std::size_t memoryEstimate(const Parameters&);
+
+    inline auto size() const { return jobs.size(); }
+    inline auto getDone() const { return done.size(); }
+    inline const Job& getJob(const std::size_t i) const { return jobs[i]; }
+};
@@ -0,0 +1,60 @@
+#include "lattice.hpp"
+#include <algorithm>
+
+
+
+void Lattice::resize(const unsigned int _width, const unsigned int _height)
+{
+    // allocate width*height spins of type +1
+
+    width = _width;
+    height = _height;
+    totalnumber = width * height;
+    selfLinks = (width == 1 ? 2 : 0) + (height == 1 ? 2 : 0);
+
+    types.assign(totalnumber, +1);
+    types.shrink_to_fit();
+}
+
+
+
+void Lattice::pack(std::uint64_t* words) const
+{
+    // packedSize() words, unused bits of the last word stay zero
+
+    for(unsigned int word=0; word<packedSize(); ++word)
+    {
+        const unsigned int begin = word * 64;
+        const unsigned int end = std::min(totalnumber, begin + 64);
+        std::uint64_t bits = 0;
+        for(unsigned int id=begin; id<end; ++id)
+            bits |= std::uint64_t(types[id] > 0) << (id - begin);
+        words[word] = bits;
+    }
+}
+
+
+
+void Lattice::unpack(const std::uint64_t* words)
+{
+    for(unsigned int id=0; id<totalnumber; ++id)
+        types[id] = ( words[id / 64] >> (id % 64) ) & 1 ? +1 : -1;
+}
+
+
+
+unsigned int Lattice::getRandomNeighbour(const unsigned int id, enhance::Engine& engine) const
+{
+    // return ID of a random neighbour, links of a spin to itself are skipped
+
+    if( selfLinks == 4 )
+        return id;
+
+    const auto N = getNeighbours(id);
+    unsigned int Nid;
+    do
+    {
+        Nid = N[enhance::bounded(engine, 4)];
+    } while( Nid == id );
+    return Nid;
+}
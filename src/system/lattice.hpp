@@ -0,0 +1,112 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <cassert>
+#include "lib/enhance.hpp"
+
+
+
+// Flat storage of a periodic width x height square lattice.
+// Spin i sits in row i/width and column i%width, every spin takes one byte
+// and all neighbours are derived by index arithmetic instead of being stored.
+class Lattice
+{
+public:
+    typedef std::int8_t spin_type;
+
+private:
+    unsigned int width {0};
+    unsigned int height {0};
+    unsigned int totalnumber {0};
+    std::vector<spin_type> types {};
+
+    // number of links of a spin to itself in 1-wide or 1-high systems,
+    // these are no neighbours and must not enter the neighbour sum
+    int selfLinks {0};
+
+public:
+    void resize(const unsigned int, const unsigned int);
+
+    inline auto getWidth()  const { return width; }
+    inline auto getHeight() const { return height; }
+    inline auto size()      const { return totalnumber; }
+    inline auto getSelfLinks() const { return selfLinks; }
+
+    inline const auto& getTypes() const { return types; }
+    inline auto data()             { return types.data(); }
+    inline auto data()       const { return types.data(); }
+
+    inline int  getType(const unsigned int id) const { return types[id]; }
+    inline void setType(const unsigned int id, const int type) { types[id] = static_cast<spin_type>(type); }
+    inline void flip(const unsigned int id) { types[id] = -types[id]; }
+
+    // one bit per spin, set for +1, spin i in bit i%64 of word i/64
+    inline auto packedSize() const { return (totalnumber + 63) / 64; }
+    void pack(std::uint64_t*) const;
+    void unpack(const std::uint64_t*);
+
+    inline std::array<unsigned int,4> getNeighbours(const unsigned int) const;   // up, right, below, left
+    inline std::array<unsigned int,4> getNeighbours(const unsigned int, const unsigned int) const;
+    unsigned int getRandomNeighbour(const unsigned int, enhance::Engine&) const;
+
+    inline int sumNeighbours(const unsigned int) const;
+    inline int sumNeighbours(const unsigned int, const unsigned int) const;
+    inline int sumOppositeNeighbours(const unsigned int) const;
+};
+
+
+
+inline std::array<unsigned int,4> Lattice::getNeighbours(const unsigned int id) const
+{
+    assert( id < totalnumber );
+
+    const unsigned int row = id / width;
+    return getNeighbours(row, id - row*width);
+}
+
+
+
+inline std::array<unsigned int,4> Lattice::getNeighbours(const unsigned int row, const unsigned int column) const
+{
+    // same as above, but for callers which already know row and column
+
+    assert( row < height && column < width );
+
+    const unsigned int id = row*width + column;
+    return
+    {{
+        row == 0 ? id + totalnumber - width : id - width,       // up
+        column == width - 1 ? id + 1 - width : id + 1,          // right
+        row == height - 1 ? id + width - totalnumber : id + width,  // below
+        column == 0 ? id + width - 1 : id - 1                   // left
+    }};
+}
+
+
+
+inline int Lattice::sumNeighbours(const unsigned int id) const
+{
+    // return sum s_i*s_j, where s_i is spin id and s_j are all neighbours of this spin
+
+    const auto N = getNeighbours(id);
+    return types[id] * (types[N[0]] + types[N[1]] + types[N[2]] + types[N[3]]) - selfLinks;
+}
+
+
+
+inline int Lattice::sumNeighbours(const unsigned int row, const unsigned int column) const
+{
+    const auto N = getNeighbours(row, column);
+    return types[row*width + column] * (types[N[0]] + types[N[1]] + types[N[2]] + types[N[3]]) - selfLinks;
+}
+
+
+
+inline int Lattice::sumOppositeNeighbours(const unsigned int id) const
+{
+    // return number of neighbours of opposite type
+
+    return (4 - selfLinks - sumNeighbours(id)) / 2;
+}
@@ -1,27 +1,36 @@
 #include "montecarlohost.hpp"
 
 
+
+constexpr unsigned int MonteCarloHost::permutationBlockSize;
+
+
 // optional:
-bool MonteCarloHost::acceptance(const double Eold, const double Enew, const double temperature)
+bool MonteCarloHost::acceptance(const int interactionChange, const int magneticChange)
 {
-    
+    // metropolis criterion looked up in the precomputed table
+
     #ifndef NDEBUG
-        double random = enhance::random_double(0.0, 1.0);
-        double condition = std::exp(-(Enew-Eold)/temperature);
-        Logger::getInstance().debug_new_line("[mc]", "random = ", random, ", exp(-(energy_new-energy_old)/temperature) = ", condition);
-        return random < condition ? true : false;
+        Logger::getInstance().debug_new_line("[mc]", "exp(-(energy_new-energy_old)/temperature) = ", acceptanceTable.probability(interactionChange, magneticChange));
     #endif
 
-    return enhance::random_double(0.0, 1.0) < std::exp(-(Enew-Eold)/temperature) ? true : false;
+    return acceptanceTable.accept(interactionChange, magneticChange, engine);
 }
 
 
 
-void MonteCarloHost::run(const unsigned long& steps, const bool EQUILMODE)
+bool MonteCarloHost::acceptance(const int interactionChange, const int magneticChange, const double proposalRatio)
 {
-    qDebug() << __PRETTY_FUNCTION__;
+    // metropolis-hastings criterion for moves whose reverse is proposed with a different probability
+
+    return acceptanceTable.acceptRatio(acceptanceTable.weight(interactionChange, magneticChange) * proposalRatio, engine);
+}
 
-    Q_CHECK_PTR(parameters);
+
+
+void MonteCarloHost::run(const unsigned long& steps, const bool EQUILMODE)
+{
+    adoptParameters();
 
      /* Aufgabe 1.6:
      *
@@ -37,133 +46,597 @@ void MonteCarloHost::run(const unsigned long& steps, const bool EQUILMODE)
      * 
      */
 
-    double energy_old;
-    double energy_new;
+    switch( parameters.scheme )
+    {
+        case UPDATESCHEME::SEQUENTIAL :     runSequential(steps);
+                                            break;
+
+        case UPDATESCHEME::PERMUTATION :    runPermutation(steps);
+                                            break;
+
+        case UPDATESCHEME::CHECKERBOARD :   runCheckerboard(steps);
+                                            break;
+
+        case UPDATESCHEME::MULTISPIN :      runMultiSpin(steps);
+                                            break;
+
+        case UPDATESCHEME::WOLFF :          runWolff(steps);
+                                            break;
+
+        case UPDATESCHEME::SWENDSENWANG :   runSwendsenWang(steps);
+                                            break;
+
+        case UPDATESCHEME::NFOLDWAY :       runNFoldWay(steps);
+                                            break;
+
+        default :                           runRandom(steps);
+                                            break;
+    }
     
+    if( EQUILMODE )
+        stepsEquilDone += steps;
+    else
+        stepsProdDone += steps;
+
+    if( !EQUILMODE )
+    {
+        const double energy = spinsystem.getHamiltonian();
+        const double magnetisation = spinsystem.getMagnetisation();
+        energyStatistics.add(energy);
+        magnetisationStatistics.add(magnetisation);
+        if( parameters.recordSamples )
+        {
+            energies.push_back(energy);
+            magnetisations.push_back(magnetisation);
+        }
+
+        if( parameters.scheme == UPDATESCHEME::MULTISPIN )
+        {
+            replicaEnergies.resize(MultiSpinsystem::replicas);
+            replicaMagnetisations.resize(MultiSpinsystem::replicas);
+            for(unsigned int r=0; r<MultiSpinsystem::replicas; ++r)
+            {
+                replicaEnergies[r].add(multiSpinsystem.getHamiltonian(r, parameters.interaction, parameters.magnetic));
+                replicaMagnetisations[r].add(multiSpinsystem.getMagnetisation(r));
+            }
+        }
+
+        if( trajectory.isOpen() && parameters.trajectoryInterval > 0 && energyStatistics.getTotal().getCount() % parameters.trajectoryInterval == 0 )
+            trajectory.append(stepsProdDone, energy, magnetisation, spinsystem.getLattice());
+    }
+
+    if( ! checkpointFile.empty() && parameters.checkpointInterval > 0
+        && std::chrono::steady_clock::now() - lastCheckpoint >= std::chrono::seconds(parameters.checkpointInterval) )
+    {
+        save_checkpoint(checkpointFile);
+        lastCheckpoint = std::chrono::steady_clock::now();
+    }
+}
+
+
+
+
+void MonteCarloHost::runRandom(const unsigned long& steps)
+{
+    // single spin moves at random sites
+
     for(unsigned int t=0; t<steps; ++t)   
     {
-        // flip spin:
-        energy_old = spinsystem.getHamiltonian();
-        spinsystem.flip();
-        energy_new = spinsystem.getHamiltonian();
+        // heat-bath spin-flip moves set the spin directly, spin-exchange moves
+        // use the heat-bath acceptance of the table instead
+        if( parameters.dynamics == DYNAMICS::HEATBATH && ! parameters.constrained )
+        {
+            spinsystem.heatBath(enhance::bounded(engine, spinsystem.getLattice().size()), acceptanceTable, engine);
+            continue;
+        }
+
+        // propose a move, the spins are only touched if it is accepted:
+        const auto move = spinsystem.propose(engine);
         
-        // check metropolis criterion:
-        if( ! acceptance(energy_old, energy_new, parameters->getTemperature()) )
+        // check metropolis criterion, spin-exchange moves carry the ratio of their proposal probabilities:
+        const bool accepted = ( parameters.constrained
+                                ? acceptance(move.interactionChange, move.magneticChange, move.proposalRatio)
+                                : acceptance(move.interactionChange, move.magneticChange) );
+        if( accepted )
         {
-            spinsystem.flip_back(); 
+            spinsystem.commit(move); 
         #ifndef NDEBUG
-            Logger::getInstance().debug_new_line("[mc]", "move rejected, new H would have been: ", energy_new);
+            Logger::getInstance().debug_new_line("[mc]", "move accepted, new H: ", spinsystem.getHamiltonian());
+            Logger::getInstance().debug_new_line(spinsystem.getStringOfSystem());
         }
         else
         {
-            Logger::getInstance().debug_new_line("[mc]", "move accepted, new H: ", energy_new);
-            Logger::getInstance().debug_new_line(spinsystem.getStringOfSystem());
+            Logger::getInstance().debug_new_line("[mc]", "move rejected");
         #endif
         }
     }
-    
-    if( !EQUILMODE )
+}
+
+
+
+inline void MonteCarloHost::updateSpin(const unsigned int id)
+{
+    // single spin move at the given site
+
+    if( parameters.dynamics == DYNAMICS::HEATBATH )
     {
-        energies.push_back(spinsystem.getHamiltonian());
-        magnetisations.push_back(spinsystem.getMagnetisation());
+        spinsystem.heatBath(id, acceptanceTable, engine);
+        return;
     }
+
+    const auto move = spinsystem.propose(id);
+    if( acceptance(move.interactionChange, move.magneticChange) )
+        spinsystem.commit(move);
 }
 
 
 
+void MonteCarloHost::runSequential(const unsigned long& sweeps)
+{
+    // typewriter sweeps, every spin is visited once per sweep in storage order
+
+    const unsigned int size = spinsystem.getLattice().size();
+    for(unsigned long sweep=0; sweep<sweeps; ++sweep)
+    {
+        for(unsigned int id=0; id<size; ++id)
+            updateSpin(id);
+    }
+}
+
+
+
+void MonteCarloHost::runPermutation(const unsigned long& sweeps)
+{
+    // every spin is visited once per sweep in random order:
+    // the blocks are visited in random order and each block is shuffled on its own,
+    // so consecutive moves stay within a few kB of the lattice
+
+    const unsigned int size = spinsystem.getLattice().size();
+    const unsigned int blocks = (size + permutationBlockSize - 1) / permutationBlockSize;
+    if( permutation.size() != size )
+    {
+        permutation.resize(size);
+        std::iota(std::begin(permutation), std::end(permutation), 0u);
+    }
+    if( blockOrder.size() != blocks )
+    {
+        blockOrder.resize(blocks);
+        std::iota(std::begin(blockOrder), std::end(blockOrder), 0u);
+    }
+
+    for(unsigned long sweep=0; sweep<sweeps; ++sweep)
+    {
+        std::shuffle(std::begin(blockOrder), std::end(blockOrder), engine);
+        for(const auto block : blockOrder)
+        {
+            const auto begin = std::begin(permutation) + block*permutationBlockSize;
+            const auto end = std::begin(permutation) + std::min(size, (block+1)*permutationBlockSize);
+            std::shuffle(begin, end, engine);
+            for(auto it = begin; it != end; ++it)
+                updateSpin(*it);
+        }
+    }
+}
+
+
+
+unsigned int MonteCarloHost::threadCount(const unsigned int maximum) const
+{
+    // number of threads requested by the parameters, at least 1 and at most maximum
+
+    const unsigned int requested = parameters.threads == 0 ? std::thread::hardware_concurrency() : parameters.threads;
+    return std::max(1u, std::min(requested, maximum));
+}
+
+
+
+template<typename WORKER>
+void MonteCarloHost::runThreads(const unsigned int threads, WORKER&& worker)
+{
+    // call worker(t) for t = 0 ... threads-1 concurrently, worker 0 runs on the calling thread
+
+    std::vector<std::thread> pool;
+    for(unsigned int t=1; t<threads; ++t)
+        pool.emplace_back(worker, t);
+    worker(0);
+    for(auto& thread : pool)
+        thread.join();
+}
+
+
+
+void MonteCarloHost::runCheckerboard(const unsigned long& sweeps)
+{
+    // metropolis sweeps over the two sublattices of the square lattice,
+    // each sublattice is split into row bands which are updated in parallel
+
+    const unsigned int height = spinsystem.getHeight();
+    const bool bipartite = spinsystem.getWidth() % 2 == 0 && height % 2 == 0;
+
+    // odd systems wrap onto the same colour, these are swept serially
+    const unsigned int threads = bipartite ? threadCount(height) : 1;
+
+    seedRows();
+
+    const auto thresholds = SublatticeKernel::thresholds(acceptanceTable, spinsystem.getLattice().getSelfLinks());
+    std::vector<long> interactionChanges(threads, 0);
+    std::vector<long> magneticChanges(threads, 0);
+    Barrier barrier(threads);
+
+    auto worker = [&](const unsigned int t)
+    {
+        const unsigned int rowBegin = t * height / threads;
+        const unsigned int rowEnd = (t+1) * height / threads;
+        long interactionChange = 0;
+        long magneticChange = 0;
+        for(unsigned long sweep=0; sweep<sweeps; ++sweep)
+        {
+            for(unsigned int colour=0; colour<2; ++colour)
+            {
+                for(unsigned int row=rowBegin; row<rowEnd; ++row)
+                    spinsystem.updateSublattice(colour, row, row+1, thresholds, engines[row], interactionChange, magneticChange);
+                barrier.wait();
+            }
+        }
+        interactionChanges[t] = interactionChange;
+        magneticChanges[t] = magneticChange;
+    };
+    runThreads(threads, worker);
+
+    spinsystem.addChanges(std::accumulate(std::begin(interactionChanges), std::end(interactionChanges), 0L), 
+                          std::accumulate(std::begin(magneticChanges), std::end(magneticChanges), 0L));
+}
+
+
+
+void MonteCarloHost::runSwendsenWang(const unsigned long& steps)
+{
+    // Swendsen-Wang updates, the row bands of all threads are labelled concurrently
+
+    const unsigned int height = spinsystem.getHeight();
+    const unsigned int threads = threadCount(height);
+
+    seedRows();
+    swendsenWang.resize(spinsystem.getLattice().size());
+    std::vector<long> interactionChanges(threads, 0);
+    std::vector<long> magneticChanges(threads, 0);
+    Barrier barrier(threads);
+
+    auto worker = [&](const unsigned int t)
+    {
+        const unsigned int rowBegin = t * height / threads;
+        const unsigned int rowEnd = (t+1) * height / threads;
+        long interactionChange = 0;
+        long magneticChange = 0;
+        for(unsigned long step=0; step<steps; ++step)
+            spinsystem.updateClusters(swendsenWang, rowBegin, rowEnd, barrier, engines, interactionChange, magneticChange);
+        interactionChanges[t] = interactionChange;
+        magneticChanges[t] = magneticChange;
+    };
+    runThreads(threads, worker);
+
+    spinsystem.addChanges(std::accumulate(std::begin(interactionChanges), std::end(interactionChanges), 0L), 
+                          std::accumulate(std::begin(magneticChanges), std::end(magneticChanges), 0L));
+}
+
+
+
+void MonteCarloHost::runMultiSpin(const unsigned long& sweeps)
+{
+    // metropolis sweeps of 64 independent replicas at once
+
+    if( multiSpinsystem.getWidth() != spinsystem.getWidth() || multiSpinsystem.getHeight() != spinsystem.getHeight() )
+        setupMultiSpin();
+
+    multiSpinsystem.sweep(acceptanceTable, sweeps);
+    multiSpinsystem.measure();
+
+    // show and record replica 0 like a single system
+    spinsystem.setSpins(multiSpinsystem.getReplica(0));
+}
+
+
+
+void MonteCarloHost::runWolff(const unsigned long& steps)
+{
+    // single-cluster updates, the dynamics setting does not apply to them
+
+    for(unsigned long t=0; t<steps; ++t)
+        spinsystem.updateCluster(wolffCluster, engine);
+}
+
+
+
+void MonteCarloHost::runNFoldWay(const unsigned long& steps)
+{
+    // continuous-time flips, records are taken at equally spaced physical times
+    // and are therefore weighted with the time spent in every configuration
+
+    spinsystem.updateContinuousTime(nFoldWay, static_cast<double>(steps), engine);
+}
+
+
+
+void MonteCarloHost::setupMultiSpin()
+{
+    // allocate and randomly initialise all replicas
+
+    multiSpinsystem.resize(spinsystem.getWidth(), spinsystem.getHeight());
+    multiSpinsystem.resetSpins(engine);
+    spinsystem.setSpins(multiSpinsystem.getReplica(0));
+}
+
+
+
+void MonteCarloHost::seedRows()
+{
+    // one vector engine per row, seeded in row order from the engine of this host,
+    // so parallel runs give the same result for any number of threads
+
+    engines.resize(spinsystem.getHeight());
+    for(auto& rowEngine : engines)
+        rowEngine.seed(engine());
+}
+
+
 
 /*
  * DER HIER FOLGENDE TEIL DER KLASSE IST NICHT RELEVANT FUER 
  * DIE IMPLEMENTIERUNGSAUFGABEN UND KANN IGNORIERT WERDEN !
  */
 
-MonteCarloHost::MonteCarloHost()
+MonteCarloHost::MonteCarloHost(const unsigned long _stream)
+    : stream(_stream)
+    , engine(enhance::streamSeed(enhance::seed, _stream))
 {
-    qDebug() << __PRETTY_FUNCTION__;
+    Logger::getInstance().debug_new_line("[mc]", "checkerboard kernel:", SublatticeKernel::name());
 }
 
 
 MonteCarloHost::~MonteCarloHost()
 {
-    qDebug() << __PRETTY_FUNCTION__;
 }
 
 
 const Spinsystem& MonteCarloHost::getSpinsystem() const
 {
-    qDebug() << __PRETTY_FUNCTION__;
-
     return spinsystem;
 }
 
 
-void MonteCarloHost::setParameters(BaseParametersWidget* prms)
+void MonteCarloHost::setParameters(const Parameters& prms)
 {
-    qDebug() << __PRETTY_FUNCTION__;
+    // publish a new snapshot, it is adopted at the beginning of the next run chunk
+    // may be called from any thread
 
-    Q_CHECK_PTR(prms);
-    parameters = prms;
-    Q_CHECK_PTR(parameters);
+    std::lock_guard<std::mutex> lock(parametersMutex);
+    pendingParameters = prms;
+    parametersPending.store(true);
 }
 
 
-void MonteCarloHost::setup()
+const Parameters& MonteCarloHost::getParameters() const
 {
-    qDebug() << __PRETTY_FUNCTION__;
-    
-    Q_CHECK_PTR(parameters);
-    
+    return parameters;
+}
+
+
+void MonteCarloHost::adoptParameters()
+{
+    // take over the latest published snapshot, if there is one
+
+    if( ! parametersPending.load() )
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(parametersMutex);
+        parameters = pendingParameters;
+        parametersPending.store(false);
+    }
+
+    // spin-exchange moves are only done at random sites
+    if( parameters.constrained )
+        parameters.scheme = UPDATESCHEME::RANDOM;
+
     spinsystem.setParameters(parameters);
-    spinsystem.setup();
+    parameters.width = spinsystem.getWidth();
+    parameters.height = spinsystem.getHeight();
+    
+    acceptanceTable.update(parameters.interaction, parameters.magnetic, parameters.temperature, parameters.dynamics);
+    wolffCluster.update(parameters.interaction, parameters.magnetic, parameters.temperature);
+    swendsenWang.update(parameters.interaction, parameters.magnetic, parameters.temperature);
+    nFoldWay.update(acceptanceTable);
+    nFoldWay.invalidate();
+    spinsystem.resetParameters();
+}
+
+
+void MonteCarloHost::setup()
+{
+    adoptParameters();
+
+    // every setup replays the stream of this host from its start
+    trajectory.close();
+    engine.seed(enhance::streamSeed(enhance::seed, stream));
+    spinsystem.setup(engine);
+    nFoldWay.invalidate();
+    if( parameters.scheme == UPDATESCHEME::MULTISPIN )
+        setupMultiSpin();
     
     clearRecords();
+    stepsEquilDone = 0;
 }
 
 
 void MonteCarloHost::resetSpins()
 {
-    qDebug() << __PRETTY_FUNCTION__;
-
-    Q_CHECK_PTR(parameters);
+    adoptParameters();
     
-    if( parameters->getWavelengthPattern() )
+    if( parameters.wavelengthPattern )
     {
-        spinsystem.resetSpinsCosinus(parameters->getWavelength());
+        spinsystem.resetSpinsCosinus(parameters.wavelength, engine);
     }
     else
     {
-        spinsystem.resetSpins();
+        spinsystem.resetSpins(engine);
     }
+    nFoldWay.invalidate();
+
+    if( parameters.scheme == UPDATESCHEME::MULTISPIN )
+        setupMultiSpin();
+}
+
+
+void MonteCarloHost::exchangeSpins(MonteCarloHost& other)
+{
+    // swap configurations with another host of the same system size
+
+    spinsystem.swapSpins(other.spinsystem);
+    nFoldWay.invalidate();
+    other.nFoldWay.invalidate();
 }
 
 
 void MonteCarloHost::clearRecords()
 {
-    qDebug() << __PRETTY_FUNCTION__;
+    adoptParameters();
 
     energies.clear();
     magnetisations.clear();
+    energyStatistics.clear();
+    magnetisationStatistics.clear();
+    replicaEnergies.clear();
+    replicaMagnetisations.clear();
+    stepsProdDone = 0;
+    if( trajectory.isOpen() )
+        trajectory.truncate(0);
 
     spinsystem.resetParameters();
     
 }
 
 
-void MonteCarloHost::print_data() const
+void MonteCarloHost::setCheckpointFile(const std::string& filename)
+{
+    // an empty name switches periodic checkpoints off
+
+    checkpointFile = filename;
+    lastCheckpoint = std::chrono::steady_clock::now();
+}
+
+
+void MonteCarloHost::save_checkpoint(const std::string& filename) const
+{
+    // everything the next run depends on, buffers which are refilled before use are left out
+
+    BinaryWriter out;
+    Checkpoint::save(out, parameters);
+    out.write(stream);
+    out.write(stepsEquilDone);
+    out.write(stepsProdDone);
+    out.write(engine.getState());
+
+    spinsystem.save(out);
+    nFoldWay.save(out);
+    out.write(permutation);
+    out.write(blockOrder);
+    out.write<std::uint8_t>( multiSpinsystem.size() != 0 );
+    if( multiSpinsystem.size() != 0 )
+        multiSpinsystem.save(out);
+
+    out.write(energies);
+    out.write(magnetisations);
+    out.write(energyStatistics);
+    out.write(magnetisationStatistics);
+    out.write(replicaEnergies);
+    out.write(replicaMagnetisations);
+
+    Checkpoint::write(filename, out.data());
+    Logger::getInstance().write_new_line("[mc]", "checkpoint written to", filename);
+}
+
+
+void MonteCarloHost::load_checkpoint(const std::string& filename)
+{
+    // set up the saved system, then overwrite its state
+
+    const std::string data = Checkpoint::read(filename);
+    BinaryReader in(data);
+
+    Parameters prms;
+    Checkpoint::load(in, prms);
+    if( in.get<unsigned long>() != stream )
+        throw std::runtime_error(filename + " belongs to a different random stream");
+    setParameters(prms);
+    setup();
+
+    in.read(stepsEquilDone);
+    in.read(stepsProdDone);
+    engine.setState(in.get<std::array<enhance::Engine::result_type, 4>>());
+
+    spinsystem.load(in);
+    nFoldWay.load(in);
+    in.read(permutation);
+    in.read(blockOrder);
+    if( in.get<std::uint8_t>() )
+        multiSpinsystem.load(in);
+
+    in.read(energies);
+    in.read(magnetisations);
+    in.read(energyStatistics);
+    in.read(magnetisationStatistics);
+    in.read(replicaEnergies);
+    in.read(replicaMagnetisations);
+    if( ! in.atEnd() )
+        throw std::runtime_error(filename + " holds more data than expected");
+
+    Logger::getInstance().write_new_line("[mc]", "checkpoint read from", filename);
+}
+
+
+void MonteCarloHost::setTrajectoryFile(const std::string& filename)
+{
+    // an existing file keeps one frame per trajectoryInterval samples recorded so far
+
+    if( filename.empty() || parameters.trajectoryInterval == 0 )
+    {
+        trajectory.close();
+        return;
+    }
+    trajectory.open(filename, spinsystem.getWidth(), spinsystem.getHeight(), energyStatistics.getTotal().getCount() / parameters.trajectoryInterval);
+}
+
+
+void MonteCarloHost::print_data(const std::string& tag) const
 {
     // save to file:  step  J  T  B  H  M  
+    // or the same as binary columns, see ColumnarData
 
-    qDebug() << __PRETTY_FUNCTION__;
     Logger::getInstance().debug_new_line("[mc]", "saving data ...");
+
+    if( ! parameters.recordSamples )
+    {
+        Logger::getInstance().write_new_line("[mc]", "samples are not recorded, no data file written");
+        return;
+    }
     
-    Q_CHECK_PTR(parameters);
-    std::string filekeystring = parameters->getFileKey();
-    std::string filekey = filekeystring.substr( 0, filekeystring.find_first_of(" ") );
-    filekey.append(".data");
+    if( parameters.dataFormat == DATAFORMAT::BINARY )
+    {
+        ColumnarData::write(outputFile(parameters, "bdata", tag), parameters, energies, magnetisations);
+        return;
+    }
 
     std::ofstream FILE;
-    FILE.open(filekey);
-    
+    FILE.open(outputFile(parameters, "data", tag));
+    print_data(FILE, parameters, energies, magnetisations);
+    FILE.close();
+}
+
+
+void MonteCarloHost::print_data(std::ostream& FILE, const Parameters& prms, const std::vector<double>& _energies, const std::vector<double>& _magnetisations)
+{
+    // text layout of the .data files, also used to convert binary ones
+
     // print header line
     FILE << std::setw(14) << "# step"
     << std::setw(8) << "J"
@@ -173,19 +646,17 @@ void MonteCarloHost::print_data() const
     << std::setw(14) << "M"
     << '\n';
     
-    assert(energies.size() == magnetisations.size());
-    for(unsigned int i=0; i<energies.size(); ++i)
+    assert(_energies.size() == _magnetisations.size());
+    for(unsigned int i=0; i<_energies.size(); ++i)
     {
-        FILE << std::setw(14) << std::fixed << std::setprecision(0)<< (i+1)*parameters->getPrintFreq()
-             << std::setw(8) << std::fixed << std::setprecision(2)<< parameters->getInteraction()
-             << std::setw(8) << std::fixed << std::setprecision(2)<< parameters->getTemperature()
-             << std::setw(8) << std::fixed << std::setprecision(2)<< parameters->getMagnetic()
-             << std::setw(14) << std::fixed << std::setprecision(2) << energies[i]
-             << std::setw(14) << std::fixed << std::setprecision(6) << magnetisations[i];
+        FILE << std::setw(14) << std::fixed << std::setprecision(0)<< (i+1)*prms.printFreq
+             << std::setw(8) << std::fixed << std::setprecision(2)<< prms.interaction
+             << std::setw(8) << std::fixed << std::setprecision(2)<< prms.temperature
+             << std::setw(8) << std::fixed << std::setprecision(2)<< prms.magnetic
+             << std::setw(14) << std::fixed << std::setprecision(2) << _energies[i]
+             << std::setw(14) << std::fixed << std::setprecision(6) << _magnetisations[i];
         FILE << '\n';
     }
-    
-    FILE.close();
 }
 
 
@@ -193,50 +664,101 @@ void MonteCarloHost::print_averages() const
 {
     // compute averages and save to file: <energy>  <magnetisation>  <susceptibility>  <heat capacity>
 
-    qDebug() << __PRETTY_FUNCTION__;
     Logger::getInstance().debug_new_line("[mc]", "saving averaged data ...");
 
-    Q_CHECK_PTR(parameters);
-    std::string filekeystring = parameters->getFileKey();
+    std::string filekeystring = parameters.fileKey;
     std::string filekey = filekeystring.substr( 0, filekeystring.find_first_of(" ") );
     filekey.append(".averaged_data");
 
     std::ofstream FILE;
     if( ! enhance::fileExists(filekey) )
     {
-        // print header line
         FILE.open(filekey);
-        FILE << std::setw(8) << "J"
-             << std::setw(8) << "T"
-             << std::setw(8) << "B"
-             << std::setw(14) << "<H>"
-             << std::setw(14) << "<M>"
-             << std::setw(18) << "<chi>"
-             << std::setw(18) << "<Cv>"
-             << std::setw(14) << "# of samples"
-             << '\n';
+        print_averages_header(FILE);
     }
     else
     {
         FILE.open(filekey, std::ios::app);
     }
-    double averageEnergies = std::accumulate(std::begin(energies), std::end(energies), 0.0) / energies.size();
-    double averageEnergiesSquared = std::accumulate(std::begin(energies), std::end(energies), 0.0, [](auto lhs, auto rhs){ return lhs + rhs*rhs; }) / energies.size();
-    double averageMagnetisations = std::accumulate(std::begin(magnetisations), std::end(magnetisations), 0.0) / magnetisations.size();
-    double averageMagnetisationsSquared = std::accumulate(std::begin(magnetisations), std::end(magnetisations), 0.0, [](auto lhs, auto rhs){ return lhs + rhs*rhs; }) / magnetisations.size();
-    double denominator = std::pow(parameters->getTemperature(),2) * std::pow(parameters->getWidth()*parameters->getHeight(),2);
+
+    print_averages(FILE);
     
-    FILE << std::setw(8) << std::fixed << std::setprecision(2) << parameters->getInteraction()
-         << std::setw(8) << std::fixed << std::setprecision(2) << parameters->getTemperature()
-         << std::setw(8) << std::fixed << std::setprecision(2) << parameters->getMagnetic()
-         << std::setw(14) << std::fixed << std::setprecision(2) << averageEnergies
-         << std::setw(14) << std::fixed << std::setprecision(6) << averageMagnetisations
-         << std::setw(18) << std::fixed << std::setprecision(10) << (averageMagnetisationsSquared - averageMagnetisations*averageMagnetisations) / parameters->getTemperature()
-         << std::setw(18) << std::fixed << std::setprecision(10) << (averageEnergiesSquared - averageEnergies*averageEnergies) / denominator
-         << std::setw(14) << energies.size() 
+    FILE.close();
+}
+
+
+void MonteCarloHost::print_averages_header(std::ostream& FILE)
+{
+    // print header line of the averaged data file
+
+    FILE << std::setw(8) << "J"
+         << std::setw(8) << "T"
+         << std::setw(8) << "B"
+         << std::setw(14) << "<H>"
+         << std::setw(14) << "<M>"
+         << std::setw(18) << "<chi>"
+         << std::setw(18) << "<Cv>"
+         << std::setw(14) << "# of samples"
+         << std::setw(14) << "U4"
+         << std::setw(14) << "d<H>"
+         << std::setw(14) << "d<M>"
+         << std::setw(18) << "d<chi>"
+         << std::setw(18) << "d<Cv>"
+         << std::setw(14) << "dU4"
+         << std::setw(12) << "tau_H"
+         << std::setw(12) << "tau_M"
          << '\n';
+}
+
+
+void MonteCarloHost::print_averages(std::ostream& FILE) const
+{
+    // append the averages of this run, multi-spin runs append one line per replica
+
+    if( replicaEnergies.empty() )
+    {
+        print_averages(FILE, energyStatistics, magnetisationStatistics);
+    }
+    else
+    {
+        for(unsigned int r=0; r<replicaEnergies.size(); ++r)
+            print_averages(FILE, replicaEnergies[r], replicaMagnetisations[r]);
+    }
+}
+
+
+void MonteCarloHost::print_averages(std::ostream& FILE, const Binning& _energies, const Binning& _magnetisations) const
+{
+    // append one line of averages of the given statistics, then the Binder cumulant U4 = 1 - <M^4>/(3<M^2>^2),
+    // the errors of all of them and the integrated autocorrelation times of H and M in samples
+    // errors of means come from the binning, those of chi, Cv and U4 from the jackknife blocks
+
+    const double temperature = parameters.temperature;
+    const double denominator = std::pow(parameters.temperature,2) * std::pow(parameters.width*parameters.height,2);
+    const auto susceptibility = _magnetisations.jackknife([&](const Accumulator& a){ return a.getVariance() / temperature; });
+    const auto heatCapacity = _energies.jackknife([&](const Accumulator& a){ return a.getVariance() / denominator; });
+    const auto binder = _magnetisations.jackknife([](const Accumulator& a){ return 1.0 - a.getMoment(4) / (3 * a.getMoment(2) * a.getMoment(2)); });
+
+    if( ! _energies.isConverged() || ! _magnetisations.isConverged() )
+        Logger::getInstance().write_new_line("[mc]", "errors at T =", temperature, "are not converged, the run is too short for its autocorrelation time");
     
-    FILE.close();
+    FILE << std::setw(8) << std::fixed << std::setprecision(2) << parameters.interaction
+         << std::setw(8) << std::fixed << std::setprecision(2) << parameters.temperature
+         << std::setw(8) << std::fixed << std::setprecision(2) << parameters.magnetic
+         << std::setw(14) << std::fixed << std::setprecision(2) << _energies.getTotal().getMean()
+         << std::setw(14) << std::fixed << std::setprecision(6) << _magnetisations.getTotal().getMean()
+         << std::setw(18) << std::fixed << std::setprecision(10) << susceptibility.first
+         << std::setw(18) << std::fixed << std::setprecision(10) << heatCapacity.first
+         << std::setw(14) << _energies.getTotal().getCount() 
+         << std::setw(14) << std::fixed << std::setprecision(6) << binder.first
+         << std::setw(14) << std::fixed << std::setprecision(4) << _energies.getError()
+         << std::setw(14) << std::fixed << std::setprecision(6) << _magnetisations.getError()
+         << std::setw(18) << std::fixed << std::setprecision(10) << susceptibility.second
+         << std::setw(18) << std::fixed << std::setprecision(10) << heatCapacity.second
+         << std::setw(14) << std::fixed << std::setprecision(6) << binder.second
+         << std::setw(12) << std::fixed << std::setprecision(2) << _energies.getTau()
+         << std::setw(12) << std::fixed << std::setprecision(2) << _magnetisations.getTau()
+         << '\n';
 }
 
 
@@ -244,11 +766,9 @@ void MonteCarloHost::print_correlation(Histogram<double>& correlation) const
 {
     // save correlation of current state in file  
 
-    qDebug() << __PRETTY_FUNCTION__;
     Logger::getInstance().debug_new_line("[mc]", "saving correlation function G(r) ...");
 
-    Q_CHECK_PTR(parameters);
-    std::string filekeystring = parameters->getFileKey();
+    std::string filekeystring = parameters.fileKey;
     std::string filekey = filekeystring.substr( 0, filekeystring.find_first_of(" ") );
     filekey.append(".correlation");
 
@@ -263,11 +783,9 @@ void MonteCarloHost::print_structureFunction(Histogram<double>& structureFunctio
 {
     // save structure Function of current state in file
 
-    qDebug() << __PRETTY_FUNCTION__;
     Logger::getInstance().debug_new_line("[mc]", "saving structure function S(k) ...");
 
-    Q_CHECK_PTR(parameters);
-    std::string filekeystring = parameters->getFileKey();
+    std::string filekeystring = parameters.fileKey;
     std::string filekey = filekeystring.substr( 0, filekeystring.find_first_of(" ") );
     filekey.append(".structureFunction");
 
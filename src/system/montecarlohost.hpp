@@ -1,22 +1,32 @@
 #pragma once
 
-#ifdef QT_NO_DEBUG
-    #ifndef QT_NO_DEBUG_OUTPUT
-        #define QT_NO_DEBUG_OUTPUT
-    #endif
-#endif
 
-
-#include "gui/parameters/base_parameters_widget.hpp"
 #include "spinsystem.hpp"
+#include "multispinsystem.hpp"
+#include "swendsenwang.hpp"
+#include "parameters.hpp"
+#include "parametersio.hpp"
+#include "acceptancetable.hpp"
+#include "checkpoint.hpp"
+#include "trajectory.hpp"
+#include "columnardata.hpp"
 #include "utility/histogram.hpp"
+#include "utility/binning.hpp"
 #include "utility/logger.hpp"
+#include "utility/barrier.hpp"
 #include "lib/enhance.hpp"
-#include <QDebug>
 #include <cassert>
 #include <cmath>
 #include <iomanip>
 #include <fstream>
+#include <string>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <random>
+#include <numeric>
+#include <algorithm>
 
 
 
@@ -24,12 +34,63 @@ class MonteCarloHost
 {
 private:
     Spinsystem           spinsystem {};
-    std::vector<double>  energies {};
+    std::vector<double>  energies {};               // every sample, only with parameters.recordSamples
     std::vector<double>  magnetisations {};
+    Binning              energyStatistics {};       // all samples with their error analysis in constant memory
+    Binning              magnetisationStatistics {};
+    AcceptanceTable      acceptanceTable {};
+
+    // random numbers of this host, stream number `stream` of the master seed enhance::seed
+    unsigned long        stream {0};
+    enhance::Engine      engine {};
+    std::vector<VectorEngine> engines {};       // one per row of parallel sweeps, independent of the number of threads
+
+    // visiting order of permuted sweeps, shuffled block by block
+    static constexpr unsigned int permutationBlockSize = 4096;  // spins per block, 4 kB of spin types
+    std::vector<unsigned int> permutation {};
+    std::vector<unsigned int> blockOrder {};
+
+    WolffCluster         wolffCluster {};
+    SwendsenWang         swendsenWang {};
+    NFoldWay             nFoldWay {};
+
+    // 64 replicas of the multi-spin scheme, spinsystem mirrors replica 0
+    MultiSpinsystem      multiSpinsystem {};
+    std::vector<Binning> replicaEnergies {};
+    std::vector<Binning> replicaMagnetisations {};
+
+    // steps done since setup, production steps since the records were cleared
+    unsigned long        stepsEquilDone {0};
+    unsigned long        stepsProdDone {0};
+
+    // written every parameters.checkpointInterval seconds while running, if a file is set
+    std::string          checkpointFile {};
+    std::chrono::steady_clock::time_point lastCheckpoint {};
+
+    // lattice snapshot every parameters.trajectoryInterval recorded samples, if a file is set
+    TrajectoryWriter     trajectory {};
     
-    bool acceptance(const double, const double, const double); // optional
+    bool acceptance(const int, const int); // optional
+    bool acceptance(const int, const int, const double);
+
+    inline void updateSpin(const unsigned int);
+    void runRandom(const unsigned long&);
+    void runSequential(const unsigned long&);
+    void runPermutation(const unsigned long&);
+    void runCheckerboard(const unsigned long&);
+    void runMultiSpin(const unsigned long&);
+    void runWolff(const unsigned long&);
+    void runSwendsenWang(const unsigned long&);
+    void runNFoldWay(const unsigned long&);
+
+    unsigned int threadCount(const unsigned int) const;
+    template<typename WORKER>
+    void runThreads(const unsigned int, WORKER&&);
+    void setupMultiSpin();
+    void seedRows();
 
 public:
+    // steps count single moves or full sweeps, depending on the update scheme
     void run(const unsigned long&, const bool EQUILMODE = false);
 
 
@@ -40,23 +101,45 @@ public:
  */
 
 private:
-    BaseParametersWidget* parameters = Q_NULLPTR;
+    Parameters parameters {};               // snapshot used by the simulation
+    Parameters pendingParameters {};        // latest published snapshot
+    std::atomic<bool> parametersPending {false};
+    std::mutex parametersMutex {};
 
 public:
-    MonteCarloHost();
+    explicit MonteCarloHost(const unsigned long = 0);
     MonteCarloHost(const MonteCarloHost&) = delete;
     void operator=(const MonteCarloHost&) = delete;
     ~MonteCarloHost();
     
-    void setParameters(BaseParametersWidget*);
+    void setParameters(const Parameters&);
+    void adoptParameters();
+    const Parameters& getParameters() const;
     void setup();
     void resetSpins();
+    void exchangeSpins(MonteCarloHost&);
+    auto getStream() const { return stream; }
     void clearRecords();
+    auto getStepsDone(const bool EQUILMODE) const { return EQUILMODE ? stepsEquilDone : stepsProdDone; }
+
+    // the complete state, a loaded host continues exactly like the saved one would have
+    void setCheckpointFile(const std::string&);
+    void save_checkpoint(const std::string&) const;
+    void load_checkpoint(const std::string&);
+
+    // has to be set after setup() or load_checkpoint(), frames beyond the recorded samples are dropped
+    void setTrajectoryFile(const std::string&);
     
     const Spinsystem& getSpinsystem() const;
+    const Binning& getEnergyStatistics() const { return energyStatistics; }
+    const Binning& getMagnetisationStatistics() const { return magnetisationStatistics; }
     
-    void print_data() const;
+    void print_data(const std::string& = "") const;  // to <fileKey>[.tag].data or .bdata
+    static void print_data(std::ostream&, const Parameters&, const std::vector<double>&, const std::vector<double>&);
     void print_averages() const;
+    void print_averages(std::ostream&) const;
+    void print_averages(std::ostream&, const Binning&, const Binning&) const;
+    static void print_averages_header(std::ostream&);
     void print_correlation(Histogram<double>&) const;
     void print_structureFunction(Histogram<double>&) const;
 };
@@ -0,0 +1,156 @@
+#include "multispinsystem.hpp"
+
+
+
+constexpr unsigned int MultiSpinsystem::replicas;
+constexpr unsigned int MultiSpinsystem::classes;
+
+
+
+void MultiSpinsystem::resize(const unsigned int _width, const unsigned int _height)
+{
+    // allocate width*height words, all replicas spin up
+
+    width = _width;
+    height = _height;
+    totalnumber = width * height;
+    selfLinks = (width == 1 ? 2 : 0) + (height == 1 ? 2 : 0);
+
+    words.assign(totalnumber, ~word_type(0));
+    words.shrink_to_fit();
+    interactionSums.fill(0);
+    spinSums.fill(0);
+}
+
+
+
+void MultiSpinsystem::resetSpins(enhance::Engine& source)
+{
+    // set all replicas randomly, each one with its own random bits,
+    // the engine of the replicas is seeded from the given one
+
+    engine.seed(source());
+    enhance::generate(engine, words.data(), words.data() + words.size());
+    measure();
+}
+
+
+
+void MultiSpinsystem::sweep(const AcceptanceTable& table, const unsigned long& sweeps)
+{
+    // metropolis sweeps in checkerboard order over all sites of all replicas
+
+    // a flip changes sum_<ij> s_i*s_j by dI = 4c - 8, c anti-aligned neighbours,
+    // and sum_i s_i by dM = -2 for up and +2 for down spins
+    for(unsigned int k=0; k<classes; ++k)
+        thresholds[k] = table.threshold(4*static_cast<int>(k/2) - 8 + 2*selfLinks, k%2 == 0 ? -2 : +2);
+
+    for(unsigned long sweep=0; sweep<sweeps; ++sweep)
+    {
+        for(unsigned int colour=0; colour<2; ++colour)
+        {
+            for(unsigned int row=0; row<height; ++row)
+            {
+                const unsigned int id = row*width;
+                const unsigned int upID = (row == 0 ? totalnumber - width : id - width);
+                const unsigned int belowID = (row == height - 1 ? 0 : id + width);
+                for(unsigned int column = (row + colour) % 2; column < width; column += 2)
+                {
+                    const unsigned int rightColumn = (column == width - 1 ? 0 : column + 1);
+                    const unsigned int leftColumn = (column == 0 ? width - 1 : column - 1);
+                    words[id + column] ^= flipMask(words[id + column], words[upID + column], words[id + rightColumn], words[belowID + column], words[id + leftColumn]);
+                }
+            }
+        }
+    }
+}
+
+
+
+void MultiSpinsystem::measure()
+{
+    // compute interaction and spin sums of all replicas
+
+    std::array<unsigned long, replicas> upSpins {};
+    std::array<unsigned long, replicas> antiAlignedBonds {};
+    for(unsigned int row=0; row<height; ++row)
+    {
+        const unsigned int id = row*width;
+        const unsigned int belowID = (row == height - 1 ? 0 : id + width);
+        for(unsigned int column=0; column<width; ++column)
+        {
+            const word_type spin = words[id + column];
+            countBits(upSpins, spin);
+            countBits(antiAlignedBonds, spin ^ words[id + (column == width - 1 ? 0 : column + 1)]);
+            countBits(antiAlignedBonds, spin ^ words[belowID + column]);
+        }
+    }
+
+    // every spin has two bonds (right and below), self links are no bonds
+    const long spins = totalnumber;
+    for(unsigned int r=0; r<replicas; ++r)
+    {
+        interactionSums[r] = 2 * spins - 2 * static_cast<long>(antiAlignedBonds[r]) - spins * selfLinks / 2;
+        spinSums[r] = 2 * static_cast<long>(upSpins[r]) - spins;
+    }
+}
+
+
+
+double MultiSpinsystem::getHamiltonian(const unsigned int replica, const double interaction, const double magnetic) const
+{
+    // Hamiltonian of one replica as of the last call to measure()
+
+    assert( replica < replicas );
+    return - interaction * interactionSums[replica] - magnetic * spinSums[replica];
+}
+
+
+
+double MultiSpinsystem::getMagnetisation(const unsigned int replica) const
+{
+    // mean magnetisation of one replica as of the last call to measure()
+
+    assert( replica < replicas );
+    return static_cast<double>(spinSums[replica]) / totalnumber;
+}
+
+
+
+std::vector<Lattice::spin_type> MultiSpinsystem::getReplica(const unsigned int replica) const
+{
+    // return spin types of one replica
+
+    assert( replica < replicas );
+
+    std::vector<Lattice::spin_type> types(totalnumber);
+    for(unsigned int id=0; id<totalnumber; ++id)
+        types[id] = (words[id] >> replica) & 1 ? +1 : -1;
+    return types;
+}
+
+
+
+void MultiSpinsystem::save(BinaryWriter& out) const
+{
+    // all replicas and the state of their random bits
+
+    out.write(width);
+    out.write(height);
+    out.write(words);
+    out.write(engine.getState());
+}
+
+
+
+void MultiSpinsystem::load(BinaryReader& in)
+{
+    const auto _width = in.get<unsigned int>();
+    const auto _height = in.get<unsigned int>();
+    resize(_width, _height);
+    in.read(words);
+    if( words.size() != totalnumber )
+        throw std::runtime_error("multi-spin replicas do not match their size");
+    engine.setState(in.get<std::array<enhance::Engine::result_type, 4>>());
+    measure();
+}
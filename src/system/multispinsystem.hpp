@@ -0,0 +1,141 @@
+#pragma once
+
+#include "lattice.hpp"
+#include "acceptancetable.hpp"
+#include "utility/binarystream.hpp"
+#include "lib/enhance.hpp"
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <cassert>
+
+
+
+// Multi-spin coded periodic width x height lattice holding 64 independent replicas.
+// Bit r of word i is spin i of replica r (1: up, 0: down), so every bitwise
+// operation on a word acts on the same site of all replicas at once.
+class MultiSpinsystem
+{
+public:
+    typedef std::uint64_t word_type;
+    static constexpr unsigned int replicas = 64;
+
+private:
+    // a site is classified by its number of anti-aligned neighbours (0..4) and its direction
+    static constexpr unsigned int classes = 10;
+
+    unsigned int width {0};
+    unsigned int height {0};
+    unsigned int totalnumber {0};
+    int selfLinks {0};
+    std::vector<word_type> words {};
+
+    // one random bit stream per replica: bit r of every draw belongs to replica r
+    enhance::Engine engine {};
+
+    std::array<std::uint64_t, classes> thresholds {};
+
+    // sum_<ij> s_i*s_j and sum_i s_i of every replica, filled by measure()
+    std::array<long, replicas> interactionSums {};
+    std::array<long, replicas> spinSums {};
+
+    inline word_type flipMask(const word_type, const word_type, const word_type, const word_type, const word_type);
+    static inline void countBits(std::array<unsigned long, replicas>&, word_type);
+
+public:
+    void resize(const unsigned int, const unsigned int);
+    void resetSpins(enhance::Engine&);
+
+    inline auto getWidth()  const { return width; }
+    inline auto getHeight() const { return height; }
+    inline auto size()      const { return totalnumber; }
+
+    void sweep(const AcceptanceTable&, const unsigned long&);
+    void measure();
+
+    void save(BinaryWriter&) const;
+    void load(BinaryReader&);
+
+    double getHamiltonian(const unsigned int, const double, const double) const;   // replica, J, B
+    double getMagnetisation(const unsigned int) const;
+    std::vector<Lattice::spin_type> getReplica(const unsigned int) const;
+};
+
+
+
+inline MultiSpinsystem::word_type MultiSpinsystem::flipMask(const word_type spin, const word_type up, const word_type right, const word_type below, const word_type left)
+{
+    // return the replicas in which the metropolis move of this site is accepted
+
+    // bit-sliced count c2 c1 c0 of anti-aligned neighbours
+    const word_type a0 = spin ^ up;
+    const word_type a1 = spin ^ right;
+    const word_type a2 = spin ^ below;
+    const word_type a3 = spin ^ left;
+    const word_type sum01 = a0 ^ a1;
+    const word_type carry01 = a0 & a1;
+    const word_type sum23 = a2 ^ a3;
+    const word_type carry23 = a2 & a3;
+    const word_type carry = sum01 & sum23;
+    const word_type c0 = sum01 ^ sum23;
+    const word_type c1 = carry01 ^ carry23 ^ carry;
+    const word_type c2 = (carry01 & carry23) | (carry & (carry01 ^ carry23));
+
+    const std::array<word_type,5> counts
+    {{
+        ~(c0 | c1 | c2),
+        c0 & ~c1 & ~c2,
+        ~c0 & c1,
+        c0 & c1,
+        c2
+    }};
+
+    // classes accepted always or never are decided right away
+    word_type accepted = 0;
+    word_type undecided = 0;
+    std::array<word_type, classes> pendingMasks;
+    std::array<std::uint64_t, classes> pendingThresholds;
+    unsigned int pending = 0;
+    for(unsigned int k=0; k<classes; ++k)
+    {
+        const word_type mask = counts[k/2] & (k%2 == 0 ? spin : ~spin);
+        if( mask == 0 || thresholds[k] == 0 )
+            continue;
+        if( thresholds[k] == AcceptanceTable::always )
+        {
+            accepted |= mask;
+            continue;
+        }
+        pendingMasks[pending] = mask;
+        pendingThresholds[pending] = thresholds[k];
+        ++pending;
+        undecided |= mask;
+    }
+
+    // every replica compares its own uniform number u to its threshold bit by bit
+    // from the top, u is decided at the first bit where both differ
+    for(int bit=63; undecided != 0 && bit >= 0; --bit)
+    {
+        word_type threshold = 0;
+        for(unsigned int p=0; p<pending; ++p)
+            threshold |= pendingMasks[p] & (word_type(0) - ((pendingThresholds[p] >> bit) & 1));
+        const word_type u = engine();
+        accepted |= undecided & threshold & ~u;
+        undecided &= ~(threshold ^ u);
+    }
+
+    return accepted;
+}
+
+
+
+inline void MultiSpinsystem::countBits(std::array<unsigned long, replicas>& counts, word_type word)
+{
+    // add one to the counter of every replica whose bit is set
+
+    while( word != 0 )
+    {
+        ++counts[__builtin_ctzll(word)];
+        word &= word - 1;
+    }
+}
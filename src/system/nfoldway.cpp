@@ -0,0 +1,77 @@
+#include "nfoldway.hpp"
+
+
+
+constexpr unsigned int NFoldWay::classes;
+constexpr unsigned int NFoldWay::none;
+
+
+
+void NFoldWay::update(const AcceptanceTable& table)
+{
+    // flipping spin s with neighbour sum h changes the interaction sum by -2h and the spin sum by -2s
+
+    for(int neighbourSum = -4; neighbourSum <= 4; ++neighbourSum)
+    for(const int spin : { +1, -1 })
+    {
+        rates[index(spin, neighbourSum)] = table.probability(-2*neighbourSum, -2*spin);
+    }
+}
+
+
+
+void NFoldWay::rebuild(const Lattice& lattice)
+{
+    // sort all spins into their classes
+
+    for(auto& list : members)
+        list.clear();
+    classOf.assign(lattice.size(), none);
+    positions.assign(lattice.size(), 0);
+    for(unsigned int id=0; id<lattice.size(); ++id)
+        assign(lattice, id);
+}
+
+
+
+void NFoldWay::invalidate()
+{
+    classOf.clear();
+}
+
+
+
+void NFoldWay::save(BinaryWriter& out) const
+{
+    // the member lists of an invalidated state are stale and left out
+
+    const bool valid = ! classOf.empty();
+    out.write(clock);
+    out.write<std::uint64_t>(classOf.size());
+    for(const auto& list : members)
+        out.write( valid ? list : std::vector<unsigned int>() );
+}
+
+
+
+void NFoldWay::load(BinaryReader& in)
+{
+    // class and position of every spin follow from the member lists, an empty size means invalidated
+
+    in.read(clock);
+    const auto size = in.get<std::uint64_t>();
+    classOf.assign(size, none);
+    positions.assign(size, 0);
+    for(unsigned int c=0; c<classes; ++c)
+    {
+        in.read(members[c]);
+        for(unsigned int position=0; position<members[c].size(); ++position)
+        {
+            const auto id = members[c][position];
+            if( id >= size )
+                throw std::runtime_error("n-fold way member out of range");
+            classOf[id] = c;
+            positions[id] = position;
+        }
+    }
+}
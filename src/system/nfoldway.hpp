@@ -0,0 +1,145 @@
+#pragma once
+
+#include "lattice.hpp"
+#include "acceptancetable.hpp"
+#include "utility/binarystream.hpp"
+#include "lib/enhance.hpp"
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <cassert>
+
+
+
+// Rejection-free continuous-time (n-fold way) single spin flips of a nearest-neighbour Ising lattice.
+// Every spin belongs to one of 18 classes given by its type and the sum s_i*sum_j s_j over
+// its neighbours, which fixes dI and dM of its flip. A class is drawn with probability
+// proportional to its number of members times its flip probability, then a member of it
+// is flipped, so no move is ever rejected. The clock advances by an exponential waiting
+// time, measured in sweeps of the equivalent single spin flip dynamics.
+// After a flip only the classes of the spin and its neighbours change.
+class NFoldWay
+{
+public:
+    static constexpr unsigned int classes = 18;
+
+private:
+    static constexpr unsigned int none = std::numeric_limits<unsigned int>::max();
+
+    std::array<double, classes> rates {};                       // flip probability of every class
+    std::array<std::vector<unsigned int>, classes> members {};  // spins of every class in arbitrary order
+    std::vector<unsigned int> classOf {};                       // class of every spin
+    std::vector<unsigned int> positions {};                     // position of every spin in its class
+    double clock {0};                                           // elapsed time in sweeps
+
+    static inline unsigned int index(const int, const int);
+    inline void assign(const Lattice&, const unsigned int);
+
+public:
+    void update(const AcceptanceTable&);    // take over flip probabilities of the current dynamics
+    void rebuild(const Lattice&);
+    void invalidate();                      // spins were changed elsewhere, rebuild before the next run
+
+    inline auto getClock() const { return clock; }
+
+    // the order within the classes decides which spin is drawn, so it is kept as it is
+    void save(BinaryWriter&) const;
+    void load(BinaryReader&);
+
+    // advance the clock by the given number of sweeps, the changes of interaction and spin sum are accumulated
+    // returns the number of flips
+    template<typename ENGINE>
+    unsigned long run(Lattice&, const double, ENGINE&, long&, long&);
+};
+
+
+
+inline unsigned int NFoldWay::index(const int spin, const int neighbourSum)
+{
+    // neighbourSum is s_i*sum_j s_j in -4 ... 4
+
+    assert( neighbourSum >= -4 && neighbourSum <= 4 );
+
+    return 2 * (neighbourSum + 4) + (spin < 0);
+}
+
+
+
+inline void NFoldWay::assign(const Lattice& lattice, const unsigned int id)
+{
+    // move a spin into the class matching its current surrounding
+
+    const unsigned int newClass = index(lattice.getType(id), lattice.sumNeighbours(id));
+    const unsigned int oldClass = classOf[id];
+    if( newClass == oldClass )
+        return;
+
+    if( oldClass != none )
+    {
+        auto& old = members[oldClass];
+        old[positions[id]] = old.back();
+        positions[old.back()] = positions[id];
+        old.pop_back();
+    }
+
+    positions[id] = members[newClass].size();
+    members[newClass].push_back(id);
+    classOf[id] = newClass;
+}
+
+
+
+template<typename ENGINE>
+unsigned long NFoldWay::run(Lattice& lattice, const double sweeps, ENGINE& engine, long& interactionChange, long& magneticChange)
+{
+    if( classOf.size() != lattice.size() )
+        rebuild(lattice);
+
+    double remaining = sweeps;
+    unsigned long flips = 0;
+
+    while( true )
+    {
+        std::array<double, classes> cumulative {};
+        double total = 0;
+        for(unsigned int c=0; c<classes; ++c)
+        {
+            total += rates[c] * members[c].size();
+            cumulative[c] = total;
+        }
+
+        // frozen configuration, nothing happens until the end of the interval
+        if( total <= 0 )
+            break;
+
+        // waiting time of the next flip in sweeps, every spin attempts one move per sweep, the exponential distribution is memoryless,
+        // so a flip beyond the end of the interval is simply dropped
+        const double waiting = -std::log1p(-enhance::canonical(engine)) / total;
+        if( waiting > remaining )
+            break;
+        remaining -= waiting;
+
+        const double target = enhance::canonical(engine) * total;
+        unsigned int c = 0;
+        while( c < classes-1 && cumulative[c] <= target )
+            ++c;
+        while( rates[c] * members[c].size() <= 0 )    // target rounded up to the total
+            --c;
+
+        const auto& candidates = members[c];
+        const unsigned int id = candidates[enhance::bounded(engine, candidates.size())];
+
+        interactionChange += -2 * lattice.sumNeighbours(id);
+        magneticChange += -2 * lattice.getType(id);
+        lattice.flip(id);
+        assign(lattice, id);
+        for(const auto neighbour : lattice.getNeighbours(id))
+            assign(lattice, neighbour);
+        ++flips;
+    }
+
+    clock += sweeps;
+    return flips;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <string>
+
+
+
+enum class UPDATESCHEME
+{
+    RANDOM,         // single spin moves at random sites, steps count moves, detailed balance
+    SEQUENTIAL,     // typewriter sweeps in storage order, steps count sweeps, global balance only
+    PERMUTATION,    // sweeps in a new random order of cache-sized blocks, steps count sweeps, global balance only
+    CHECKERBOARD,   // parallel sweeps over both sublattices, steps count sweeps
+    MULTISPIN,      // 64 multi-spin coded replicas at once, steps count sweeps
+    WOLFF,          // single-cluster updates, steps count cluster flips
+    SWENDSENWANG,   // parallel updates of all clusters, steps count lattice updates
+    NFOLDWAY        // rejection-free continuous-time single spin flips, steps count sweeps of physical time
+};
+
+
+
+enum class DYNAMICS
+{
+    METROPOLIS,     // flip with probability min(1, exp(-dH/T))
+    HEATBATH        // draw the spin from its local field, flips with probability 1/(1+exp(dH/T))
+};
+
+
+
+enum class DATAFORMAT
+{
+    TEXT,           // <fileKey>.data, one fixed-width line per sample
+    BINARY          // <fileKey>.bdata, parameters once and XOR-compressed columns, see columnardata.hpp
+};
+
+
+
+// Plain value-type snapshot of all simulation parameters.
+// Spinsystem and MonteCarloHost work on their own copy, so the simulation
+// never has to reach into the widgets while it is running.
+struct Parameters
+{
+    // system
+    unsigned int  width {50};
+    unsigned int  height {50};
+    double        interaction {1.0};    // J
+    double        magnetic {0.0};       // B
+    double        temperature {1.0};    // T
+
+    // mode
+    bool          constrained {false};  // spin-exchange mode
+    double        ratio {0.5};          // ratio of down spins if constrained
+    bool          wavelengthPattern {false};
+    int           wavelength {0};
+
+    // algorithm
+    UPDATESCHEME  scheme {UPDATESCHEME::RANDOM};
+    DYNAMICS      dynamics {DYNAMICS::METROPOLIS};
+    unsigned int  threads {0};          // 0: use all hardware threads
+
+    // run
+    unsigned long stepsEquil {1000000};
+    unsigned long stepsProd {5000000};
+    unsigned int  printFreq {100};
+    unsigned int  checkpointInterval {0};   // seconds between checkpoints, 0: only on request
+    unsigned int  trajectoryInterval {0};   // recorded samples between lattice snapshots, 0: none
+    bool          recordSamples {true};     // keep every sample for the .data file, the averages never need them
+
+    // output
+    std::string   fileKey {"ising"};
+    DATAFORMAT    dataFormat {DATAFORMAT::TEXT};
+};
@@ -0,0 +1,267 @@
+#include "parametersio.hpp"
+#include <fstream>
+#include <sstream>
+#include <limits>
+#include <cctype>
+#include <cmath>
+
+
+
+namespace
+{
+    const std::vector<std::pair<UPDATESCHEME, std::string>> schemeNames {
+        { UPDATESCHEME::RANDOM,       "random" },
+        { UPDATESCHEME::SEQUENTIAL,   "sequential" },
+        { UPDATESCHEME::PERMUTATION,  "permutation" },
+        { UPDATESCHEME::CHECKERBOARD, "checkerboard" },
+        { UPDATESCHEME::MULTISPIN,    "multispin" },
+        { UPDATESCHEME::WOLFF,        "wolff" },
+        { UPDATESCHEME::SWENDSENWANG, "swendsenwang" },
+        { UPDATESCHEME::NFOLDWAY,     "nfoldway" }
+    };
+
+    const std::vector<std::pair<DYNAMICS, std::string>> dynamicsNames {
+        { DYNAMICS::METROPOLIS, "metropolis" },
+        { DYNAMICS::HEATBATH,   "heatbath" }
+    };
+
+    const std::vector<std::pair<DATAFORMAT, std::string>> dataFormatNames {
+        { DATAFORMAT::TEXT,   "text" },
+        { DATAFORMAT::BINARY, "binary" }
+    };
+
+
+    std::string lower(std::string text)
+    {
+        for(auto& c : text)
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        return text;
+    }
+}
+
+
+
+std::string trim(const std::string& text)
+{
+    const auto first = text.find_first_not_of(" \t\r");
+    if( first == std::string::npos )
+        return std::string();
+    const auto last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+
+
+std::pair<std::string, std::string> splitSetting(const std::string& line)
+{
+    // "key = value" or "key=value", the value may be empty
+
+    const auto equals = line.find('=');
+    if( equals == std::string::npos )
+        throw std::invalid_argument("expected key = value in '" + line + "'");
+    return std::make_pair(trim(line.substr(0, equals)), trim(line.substr(equals + 1)));
+}
+
+
+
+Settings readSettings(std::istream& stream)
+{
+    // all settings in file order, later ones win when applied
+
+    Settings settings;
+    std::string line;
+    while( std::getline(stream, line) )
+    {
+        line = trim(line.substr(0, line.find('#')));
+        if( ! line.empty() )
+            settings.push_back(splitSetting(line));
+    }
+    return settings;
+}
+
+
+
+Settings readSettings(const std::string& filename)
+{
+    std::ifstream FILE(filename);
+    if( ! FILE.is_open() )
+        throw std::invalid_argument("cannot open " + filename);
+    return readSettings(FILE);
+}
+
+
+
+bool setParameter(Parameters& prms, const std::string& key, const std::string& value)
+{
+    const std::string name = lower(key);
+
+    if( name == "width" )                           prms.width = toNumber<unsigned int>(key, value);
+    else if( name == "height" )                     prms.height = toNumber<unsigned int>(key, value);
+    else if( name == "interaction" || key == "J" )  prms.interaction = toNumber<double>(key, value);
+    else if( name == "magnetic" || key == "B" )     prms.magnetic = toNumber<double>(key, value);
+    else if( name == "temperature" || key == "T" )  prms.temperature = toNumber<double>(key, value);
+    else if( name == "constrained" )                prms.constrained = toBool(value);
+    else if( name == "ratio" )                      prms.ratio = toNumber<double>(key, value);
+    else if( name == "wavelengthpattern" )          prms.wavelengthPattern = toBool(value);
+    else if( name == "wavelength" )                 prms.wavelength = toNumber<int>(key, value);
+    else if( name == "scheme" )                     prms.scheme = toScheme(value);
+    else if( name == "dynamics" )                   prms.dynamics = toDynamics(value);
+    else if( name == "threads" )                    prms.threads = toNumber<unsigned int>(key, value);
+    else if( name == "stepsequil" )                 prms.stepsEquil = toNumber<unsigned long>(key, value);
+    else if( name == "stepsprod" )                  prms.stepsProd = toNumber<unsigned long>(key, value);
+    else if( name == "printfreq" )                  prms.printFreq = toNumber<unsigned int>(key, value);
+    else if( name == "checkpointinterval" )         prms.checkpointInterval = toNumber<unsigned int>(key, value);
+    else if( name == "trajectoryinterval" )         prms.trajectoryInterval = toNumber<unsigned int>(key, value);
+    else if( name == "recordsamples" )              prms.recordSamples = toBool(value);
+    else if( name == "filekey" )                    prms.fileKey = value;
+    else if( name == "dataformat" )                 prms.dataFormat = toDataFormat(value);
+    else
+        return false;
+
+    return true;
+}
+
+
+
+void checkParameters(const Parameters& prms)
+{
+    // values a run cannot start with, NaN fails the comparisons as well
+
+    if( prms.width == 0 || prms.height == 0 )
+        throw std::invalid_argument("width and height have to be positive");
+    if( !(prms.temperature > 0) )
+        throw std::invalid_argument("temperature has to be positive");
+    if( prms.constrained && !(prms.ratio > 0 && prms.ratio < 1) )
+        throw std::invalid_argument("ratio has to lie between 0 and 1 for constrained runs");
+    if( prms.printFreq == 0 )
+        throw std::invalid_argument("printFreq has to be positive");
+}
+
+
+
+void writeParameters(std::ostream& stream, const Parameters& prms)
+{
+    // readable again by readSettings and setParameter, doubles survive the round trip
+
+    const auto precision = stream.precision(std::numeric_limits<double>::max_digits10);
+    stream << "width = "              << prms.width << '\n'
+           << "height = "             << prms.height << '\n'
+           << "interaction = "        << prms.interaction << '\n'
+           << "magnetic = "           << prms.magnetic << '\n'
+           << "temperature = "        << prms.temperature << '\n'
+           << "constrained = "        << (prms.constrained ? "true" : "false") << '\n'
+           << "ratio = "              << prms.ratio << '\n'
+           << "wavelengthPattern = "  << (prms.wavelengthPattern ? "true" : "false") << '\n'
+           << "wavelength = "         << prms.wavelength << '\n'
+           << "scheme = "             << toString(prms.scheme) << '\n'
+           << "dynamics = "           << toString(prms.dynamics) << '\n'
+           << "threads = "            << prms.threads << '\n'
+           << "stepsEquil = "         << prms.stepsEquil << '\n'
+           << "stepsProd = "          << prms.stepsProd << '\n'
+           << "printFreq = "          << prms.printFreq << '\n'
+           << "checkpointInterval = " << prms.checkpointInterval << '\n'
+           << "trajectoryInterval = " << prms.trajectoryInterval << '\n'
+           << "recordSamples = "      << (prms.recordSamples ? "true" : "false") << '\n'
+           << "fileKey = "            << prms.fileKey << '\n'
+           << "dataFormat = "         << toString(prms.dataFormat) << '\n';
+    stream.precision(precision);
+}
+
+
+
+std::string outputFile(const Parameters& prms, const std::string& extension, const std::string& tag)
+{
+    // next to the other output files of the run, the file key ends at its first space
+
+    std::string name = prms.fileKey.substr( 0, prms.fileKey.find_first_of(" ") );
+    if( ! tag.empty() )
+        name.append("." + tag);
+    return name.append("." + extension);
+}
+
+
+
+std::string toString(const UPDATESCHEME scheme)
+{
+    for(const auto& entry : schemeNames)
+        if( entry.first == scheme )
+            return entry.second;
+    throw std::logic_error("unnamed update scheme");
+}
+
+
+
+std::string toString(const DYNAMICS dynamics)
+{
+    for(const auto& entry : dynamicsNames)
+        if( entry.first == dynamics )
+            return entry.second;
+    throw std::logic_error("unnamed dynamics");
+}
+
+
+
+std::string toString(const DATAFORMAT format)
+{
+    for(const auto& entry : dataFormatNames)
+        if( entry.first == format )
+            return entry.second;
+    throw std::logic_error("unnamed data format");
+}
+
+
+
+UPDATESCHEME toScheme(const std::string& name)
+{
+    for(const auto& entry : schemeNames)
+        if( entry.second == lower(name) )
+            return entry.first;
+    throw std::invalid_argument("unknown update scheme '" + name + "'");
+}
+
+
+
+DYNAMICS toDynamics(const std::string& name)
+{
+    for(const auto& entry : dynamicsNames)
+        if( entry.second == lower(name) )
+            return entry.first;
+    throw std::invalid_argument("unknown dynamics '" + name + "'");
+}
+
+
+
+DATAFORMAT toDataFormat(const std::string& name)
+{
+    for(const auto& entry : dataFormatNames)
+        if( entry.second == lower(name) )
+            return entry.first;
+    throw std::invalid_argument("unknown data format '" + name + "'");
+}
+
+
+
+bool toBool(const std::string& value)
+{
+    const std::string name = lower(value);
+    if( name == "true" || name == "yes" || name == "on" || name == "1" || name.empty() )
+        return true;
+    if( name == "false" || name == "no" || name == "off" || name == "0" )
+        return false;
+    throw std::invalid_argument("invalid boolean '" + value + "'");
+}
+
+
+
+std::vector<double> sweepRange(const double start, const double step, const double stop)
+{
+    // start, start+step, ... up to stop, without accumulating rounding errors
+
+    if( step <= 0 || stop < start )
+        throw std::invalid_argument("a range needs step > 0 and stop >= start");
+    const auto count = static_cast<unsigned long>(std::floor((stop - start) / step + 1e-9)) + 1;
+    std::vector<double> values;
+    for(unsigned long i=0; i<count; ++i)
+        values.push_back(start + i * step);
+    return values;
+}
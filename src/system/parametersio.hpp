@@ -0,0 +1,52 @@
+#pragma once
+
+#include "parameters.hpp"
+#include <string>
+#include <vector>
+#include <utility>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <sstream>
+#include <type_traits>
+
+
+
+// Text form of Parameters for batch runs: one "key = value" per line, '#' starts a comment.
+// Keys are the member names (J, T and B work as well), schemes and dynamics are given by name.
+// Malformed values throw std::invalid_argument.
+
+typedef std::vector<std::pair<std::string, std::string>> Settings;
+
+Settings readSettings(std::istream&);
+Settings readSettings(const std::string&);                  // from a file
+std::pair<std::string, std::string> splitSetting(const std::string&);
+std::string trim(const std::string&);
+
+bool setParameter(Parameters&, const std::string&, const std::string&);   // false for unknown keys
+void checkParameters(const Parameters&);                    // throws for values a run cannot start with, once all settings are applied
+void writeParameters(std::ostream&, const Parameters&);
+std::string outputFile(const Parameters&, const std::string&, const std::string& = "");  // <fileKey>[.tag].extension
+
+std::string  toString(const UPDATESCHEME);
+std::string  toString(const DYNAMICS);
+std::string  toString(const DATAFORMAT);
+UPDATESCHEME toScheme(const std::string&);
+DYNAMICS     toDynamics(const std::string&);
+DATAFORMAT   toDataFormat(const std::string&);
+bool         toBool(const std::string&);
+
+std::vector<double> sweepRange(const double, const double, const double);   // start, step, stop
+
+
+
+// the whole value has to be a number of type T, key names the setting in the error message
+template<typename T>
+T toNumber(const std::string& key, const std::string& value)
+{
+    std::istringstream stream(value);
+    T number {};
+    if( value.empty() || (std::is_unsigned<T>::value && value.front() == '-') || !(stream >> number) || !(stream >> std::ws).eof() )
+        throw std::invalid_argument("invalid value '" + value + "' for " + key);
+    return number;
+}
@@ -0,0 +1,105 @@
+#include "replicaexchange.hpp"
+
+
+
+void ReplicaExchange::setup(const Parameters& prms, const std::vector<double>& _temperatures)
+{
+    // one host per temperature with its own random stream, the threads are spent on the replicas
+
+    temperatures = _temperatures;
+    threads = prms.threads == 0 ? std::thread::hardware_concurrency() : prms.threads;
+    threads = std::max(1u, std::min<unsigned int>(threads, temperatures.size()));
+
+    hosts.clear();
+    for(std::size_t i=0; i<temperatures.size(); ++i)
+    {
+        Parameters replica = prms;
+        replica.temperature = temperatures[i];
+        replica.threads = 1;
+
+        // spinsystem of a multi-spin host only mirrors one of its replicas, so it cannot take over configurations
+        if( replica.scheme == UPDATESCHEME::MULTISPIN )
+            replica.scheme = UPDATESCHEME::CHECKERBOARD;
+
+        hosts.emplace_back(new MonteCarloHost(i+1));
+        hosts.back()->setParameters(replica);
+        hosts.back()->setup();
+    }
+
+    engine.seed(enhance::streamSeed(enhance::seed, temperatures.size()+1));
+    attempted.assign(temperatures.empty() ? 0 : temperatures.size()-1, 0);
+    accepted.assign(attempted.size(), 0);
+    evenPairs = true;
+}
+
+
+
+void ReplicaExchange::run(const unsigned long& steps, const bool EQUILMODE)
+{
+    // all hosts run the same number of steps, workers take the next host which is not yet done
+
+    std::atomic<std::size_t> next {0};
+    auto worker = [&]
+    {
+        for(std::size_t i = next++; i < hosts.size(); i = next++)
+            hosts[i]->run(steps, EQUILMODE);
+    };
+
+    std::vector<std::thread> pool;
+    for(unsigned int t=1; t<threads; ++t)
+        pool.emplace_back(worker);
+    worker();
+    for(auto& thread : pool)
+        thread.join();
+
+    exchange();
+}
+
+
+
+void ReplicaExchange::exchange()
+{
+    // propose swaps of all even or all odd neighbouring pairs
+
+    for(std::size_t i = (evenPairs ? 0 : 1); i+1 < hosts.size(); i += 2)
+    {
+        const double delta = (1.0/temperatures[i] - 1.0/temperatures[i+1])
+                           * (hosts[i]->getSpinsystem().getHamiltonian() - hosts[i+1]->getSpinsystem().getHamiltonian());
+        ++attempted[i];
+        if( delta >= 0 || enhance::canonical(engine) < std::exp(delta) )
+        {
+            hosts[i]->exchangeSpins(*hosts[i+1]);
+            ++accepted[i];
+        }
+    }
+    evenPairs = !evenPairs;
+}
+
+
+
+void ReplicaExchange::clearRecords()
+{
+    for(auto& host : hosts)
+        host->clearRecords();
+}
+
+
+
+double ReplicaExchange::getAcceptanceRate(const std::size_t pair) const
+{
+    // fraction of accepted swaps between temperature pair and pair+1
+
+    return attempted[pair] == 0 ? 0.0 : static_cast<double>(accepted[pair]) / attempted[pair];
+}
+
+
+
+void ReplicaExchange::print_averages() const
+{
+    // one line per temperature in the averaged data file
+
+    for(const auto& host : hosts)
+        host->print_averages();
+    for(std::size_t i=0; i<attempted.size(); ++i)
+        Logger::getInstance().write_new_line("[replica exchange]", "T =", temperatures[i], "<->", temperatures[i+1], "swap acceptance", getAcceptanceRate(i));
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "montecarlohost.hpp"
+#include "parameters.hpp"
+#include "lib/enhance.hpp"
+#include "utility/logger.hpp"
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+
+
+
+// Parallel tempering: one MonteCarloHost per temperature, all of them run concurrently.
+// After every run chunk configurations of neighbouring temperatures are swapped with
+// probability min(1, exp((1/T_i - 1/T_j)(H_i - H_j))), alternating between even and odd pairs.
+// Host i always stays at temperature i, so its records belong to a single temperature.
+class ReplicaExchange
+{
+private:
+    std::vector<std::unique_ptr<MonteCarloHost>> hosts {};
+    std::vector<double> temperatures {};
+    std::vector<unsigned long> attempted {};    // swaps of pair (i, i+1)
+    std::vector<unsigned long> accepted {};
+    unsigned int threads {1};
+    bool evenPairs {true};
+    enhance::Engine engine {};
+
+    void exchange();
+
+public:
+    void setup(const Parameters&, const std::vector<double>&);
+    void run(const unsigned long&, const bool EQUILMODE = false);
+    void clearRecords();
+
+    inline auto size() const { return hosts.size(); }
+    inline const MonteCarloHost& getHost(const std::size_t i) const { return *hosts[i]; }
+    double getAcceptanceRate(const std::size_t) const;
+
+    void print_averages() const;
+};
@@ -2,7 +2,7 @@
 
 
 
-double Spinsystem::localEnergyInteraction(const Spin& _spin) const
+double Spinsystem::localEnergyInteraction(const unsigned int _id) const
 {
     /* Aufgabe 1.2:
      *
@@ -11,12 +11,12 @@ double Spinsystem::localEnergyInteraction(const Spin& _spin) const
      * Funktion: Berechnung des return Wertes
      */
 
-    return - getInteraction() * _spin.sumNeighbours();
+    return - getInteraction() * spins.sumNeighbours(_id);
 }
 
 
 
-double Spinsystem::localEnergyMagnetic(const Spin& _spin) const
+double Spinsystem::localEnergyMagnetic(const unsigned int _id) const
 {
     /* Aufgabe 1.2:
      *
@@ -25,7 +25,7 @@ double Spinsystem::localEnergyMagnetic(const Spin& _spin) const
      * Funktion: Berechnung des return Wertes.
      */
 
-    return - getMagnetic() * _spin.getType();
+    return - getMagnetic() * spins.getType(_id);
 }
 
 
@@ -41,79 +41,142 @@ void Spinsystem::computeHamiltonian()
      *           dieses Wertes in der Membervariable "Hamiltonian".
      */
 
-    Hamiltonian = 0;
-    for(const auto& S : spins)
+    interactionSum = 0;
+    spinSum = 0;
+    for(unsigned int id=0; id<spins.size(); ++id)
     {
-        Hamiltonian += localEnergyInteraction(S) / 2 + localEnergyMagnetic(S);
+        interactionSum += spins.sumNeighbours(id);
+        spinSum += spins.getType(id);
     }
+    interactionSum /= 2;    // every bond has been counted from both sides
+
+    Hamiltonian = - getInteraction() * interactionSum - getMagnetic() * spinSum;
+}
+
+
+
+void Spinsystem::resetInterface()
+{
+    // the interface is only needed to draw spin-exchange moves
+
+    if( getSpinExchange() )
+        interface.rebuild(spins);
+    else
+        interface.clear();
+}
+
+
+
+Spinsystem::Move Spinsystem::propose(enhance::Engine& engine) const
+{
+    // draw a move and compute its changes without touching the spins:
+    // a random spin in spin-flip mode, a random bond of the interface in spin-exchange mode
+
+    if( ! getSpinExchange() )
+        return propose( enhance::bounded(engine, spins.size()) );
+
+    Move move {};
+    if( interface.size() == 0 )
+        return move;
+
+    const unsigned int bond = interface.getBond( enhance::bounded(engine, interface.size()) );
+    move.first = InterfaceBonds::first(spins, bond);
+    move.second = InterfaceBonds::second(spins, bond);
+    move.size = 2;
+
+    // the bonds between both spins stay anti-aligned, every other bond of them changes its sign
+    const auto N = spins.getNeighbours(move.first);
+    const int links = std::count(std::begin(N), std::end(N), move.second);
+    move.interactionChange = -2 * (spins.sumNeighbours(move.first) + spins.sumNeighbours(move.second) + 2*links);
+    move.magneticChange = 0;
+
+    // the reverse move draws the same bond from the new interface, which changes its length by -dI/2
+    const double bondsBefore = interface.size();
+    move.proposalRatio = bondsBefore / (bondsBefore - move.interactionChange/2);
+    return move;
+}
+
+
+
+Spinsystem::Move Spinsystem::propose(const unsigned int id) const
+{
+    // flip of the given spin (spin-flip mode)
+
+    Move move {};
+    move.first = id;
+    move.second = id;
+    move.size = 1;
+    move.interactionChange = -2 * spins.sumNeighbours(id);
+    move.magneticChange = -2 * spins.getType(id);
+    return move;
 }
 
 
 
-void Spinsystem::flip()
+void Spinsystem::commit(const Move& move)
+{
+    // carry out a proposed move
+
+    if( move.size == 0 )
+        return;
+
+    spins.flip(move.first);
+    if( move.size == 2 )
+    {
+        spins.flip(move.second);
+        interface.update(spins, move.first);
+        interface.update(spins, move.second);
+    }
+    addChanges(move.interactionChange, move.magneticChange);
+
+    Logger::getInstance().debug_new_line("[spinsystem]",  "flipping spins: ", move.first, " ", move.second);
+}
+
+
+
+void Spinsystem::flip(enhance::Engine& engine)
 {
     /* Aufgabe 1.4:
      *
-     * input:    /
+     * input:    Zufallszahlengenerator
      * return:   /
      * Funktion: - Im spin-flip Modus:
      *              Auswahl eines zufälligen Spins, Flip dieses Spins, 
      *              Update des Hamiltonian, Abspeichern dieses Spins in
-     *              der Membervariable lastFlipped
+     *              der Membervariable lastMove
      *           - Im spin-exchange Modus:
-     *              Auswahl eines zufälligen Spins und eines weiteren, 
-     *              zufälligen, Nachbarspins mit entgegengesetzer Ausrichtung, 
+     *              Auswahl eines zufälligen Paares entgegengesetzter Nachbarspins, 
      *              Flip dieser beiden Spins, Update des Hamiltonian, Abspeichern
-     *              der geflippten Spins in der Membervariable lastFlipped
+     *              der geflippten Spins in der Membervariable lastMove
      */
 
-    lastFlipped.clear();    // contains ID's of spins that have been flipped in last move
-    double localEnergy_before = 0;
-    double localEnergy_after = 0;
+    lastMove = propose(engine);
+    commit(lastMove);
+}
 
-    if( ! getSpinExchange() )
-    {
-        // find random spin
-        unsigned int randomSpinID = enhance::random_int(0, spins.size()-1);
-        lastFlipped.emplace_back( randomSpinID );
-        // flip spin
-        localEnergy_before = localEnergyInteraction( spins[randomSpinID] ) + localEnergyMagnetic( spins[randomSpinID] );
-        spins[randomSpinID].flip();
-        localEnergy_after = localEnergyInteraction( spins[randomSpinID] ) + localEnergyMagnetic( spins[randomSpinID] );
-        // update Hamiltonian:
-        Hamiltonian += localEnergy_after - localEnergy_before;
-    }
-    else
-    {
-        // find random spin
-        unsigned int randomSpinID = enhance::random_int(0, spins.size()-1);
-        do
-        {
-            randomSpinID = enhance::random_int(0, spins.size()-1);
-        } while( spins[randomSpinID].sumOppositeNeighbours() == 0 );
-        
-        // find random neighbour
-        unsigned int randomNeighbourID = spins[randomSpinID].getRandomNeighbour().getID();
-        do
-        {
-            randomNeighbourID = spins[randomSpinID].getRandomNeighbour().getID();
-        } while( spins[randomSpinID].getType() == spins[randomNeighbourID].getType() );
-        
-        // flip spins
-        lastFlipped.emplace_back(randomSpinID);
-        lastFlipped.emplace_back(randomNeighbourID);
-        localEnergy_before = localEnergyInteraction(spins[randomSpinID]) + localEnergyInteraction(spins[randomNeighbourID]);
-        spins[randomSpinID].flip();
-        spins[randomNeighbourID].flip();
-        localEnergy_after = localEnergyInteraction(spins[randomSpinID]) + localEnergyInteraction(spins[randomNeighbourID]);
-
-        // update Hamiltonian
-        Hamiltonian += localEnergy_after - localEnergy_before;
-        
-    }
 
-    Logger::getInstance().debug_new_line("[spinsystem]",  "flipping spin: ");
-    for(const auto& spinID: lastFlipped) Logger::getInstance().debug( " ", spinID);
+
+void Spinsystem::flip(const unsigned int id)
+{
+    // flip the given spin (spin-flip mode)
+
+    lastMove = propose(id);
+    commit(lastMove);
+}
+
+
+
+void Spinsystem::heatBath(const unsigned int id, const AcceptanceTable& table, enhance::Engine& engine)
+{
+    // draw the given spin anew from its local field (spin-flip mode), nothing to flip back
+
+    const int spin = spins.getType(id);
+    const int interaction = spins.sumNeighbours(id);
+    if( table.heatBath(spin * interaction, engine) == spin )
+        return;
+
+    spins.flip(id);
+    addChanges(-2 * interaction, -2 * spin);
 }
 
 
@@ -127,274 +190,215 @@ void Spinsystem::flip_back()
      * Funktion: Macht den gesamten in flip() durchgeführten Prozess rückgängig. 
      */
 
-    double localEnergy_before = 0;
-    double localEnergy_after = 0;
-    // flip spins back:
-    for( const auto& id: lastFlipped ) 
-    {
-        localEnergy_before += localEnergyInteraction( spins[id] ) + localEnergyMagnetic( spins[id] );
-    }
-    for( const auto& id: lastFlipped ) 
-    {
-        spins[id].flip();
-    }
-    for( const auto& id: lastFlipped ) 
-    {
-        localEnergy_after += localEnergyInteraction( spins[id] ) + localEnergyMagnetic( spins[id] );
-    }
-    // update Hamiltonian
-    Hamiltonian += localEnergy_after - localEnergy_before;
+    // the reverse move flips the same spins with opposite changes
+    Move reverse = lastMove;
+    reverse.interactionChange = -lastMove.interactionChange;
+    reverse.magneticChange = -lastMove.magneticChange;
+    commit(reverse);
+    lastMove = Move {};
 
-    Logger::getInstance().debug_new_line("[spinsystem]", "flipping back: ");
-    for(const auto& id: lastFlipped) Logger::getInstance().debug("  ", id);
+    Logger::getInstance().debug_new_line("[spinsystem]", "flipped back");
 }
 
 
 
-double Spinsystem::getMagnetisation() const
+void Spinsystem::updateSublattice(const unsigned int colour, const unsigned int rowBegin, const unsigned int rowEnd, const SublatticeKernel::Thresholds& thresholds, VectorEngine& engine, long& interactionChange, long& magneticChange)
 {
-    /* Aufgabe 1.5:
-     *
-     * input:    /
-     * return:   Mittlere Magnetisierung M
-     * Funktion: Berechnung der mittleren Magnetisierung M für die aktuelle Spin-
-     *           konfiguration.  
-     */
+    // metropolis update of all spins with (row+column)%2 == colour in rows [rowBegin, rowEnd)
+    // the changes of interaction and spin sum are accumulated, the Hamiltonian is left alone
+    // spins of the other colour are only read, so disjoint row ranges can be updated concurrently
 
-    int sum = 0;
-    for( const auto& S: spins )
-    {
-        sum += S.getType();
-    }
-    return static_cast<double>(sum) / spins.size();
+    SublatticeKernel::update(spins, colour, rowBegin, rowEnd, thresholds, engine, interactionChange, magneticChange);
 }
 
 
 
+void Spinsystem::addChanges(const long interactionChange, const long magneticChange)
+{
+    // update observables after spins have been flipped, e.g. via updateSublattice()
+    // the Hamiltonian follows from the exact integer sums, so no rounding errors pile up
 
-/*
- * DER HIER FOLGENDE TEIL DER KLASSE NICHT RELEVANT FUER 
- * DIE IMPLEMENTIERUNGSAUFGABEN UND KANN IGNORIERT WERDEN !
- */
-
-unsigned long Spinsystem::getHeight() const 
-{ 
-    Q_CHECK_PTR(parameters); 
-    return parameters->getHeight(); 
+    interactionSum += interactionChange;
+    spinSum += magneticChange;
+    Hamiltonian = - getInteraction() * interactionSum - getMagnetic() * spinSum;
 }
 
 
-unsigned long Spinsystem::getWidth() const 
-{ 
-    Q_CHECK_PTR(parameters); 
-    return parameters->getWidth(); 
-}
-
 
-double Spinsystem::getInteraction() const 
-{ 
-    Q_CHECK_PTR(parameters); 
-    return parameters->getInteraction(); 
-}
+bool Spinsystem::updateCluster(WolffCluster& cluster, enhance::Engine& engine)
+{
+    // grow and flip one Wolff cluster, returns false if the flip was rejected
 
+    long interactionChange = 0;
+    long magneticChange = 0;
+    const bool flipped = cluster.flip(spins, engine, interactionChange, magneticChange);
+    addChanges(interactionChange, magneticChange);
 
-double Spinsystem::getMagnetic() const 
-{ 
-    Q_CHECK_PTR(parameters); 
-    return parameters->getMagnetic(); 
+    Logger::getInstance().debug_new_line("[spinsystem]", "cluster of size", cluster.size(), flipped ? "flipped" : "rejected");
+    return flipped;
 }
 
 
-bool Spinsystem::getSpinExchange() const 
-{ 
-    Q_CHECK_PTR(parameters); 
-    return parameters->getConstrained(); 
-}
 
+unsigned long Spinsystem::updateContinuousTime(NFoldWay& nFoldWay, const double sweeps, enhance::Engine& engine)
+{
+    // rejection-free flips for the given physical time, returns the number of flips
 
-double Spinsystem::getRatio() const 
-{ 
-    Q_CHECK_PTR(parameters); 
-    return parameters->getRatio(); 
+    long interactionChange = 0;
+    long magneticChange = 0;
+    const auto flips = nFoldWay.run(spins, sweeps, engine, interactionChange, magneticChange);
+    addChanges(interactionChange, magneticChange);
+
+    Logger::getInstance().debug_new_line("[spinsystem]", flips, "flips until time", nFoldWay.getClock());
+    return flips;
 }
 
 
-bool Spinsystem::getWavelengthPattern() const 
-{ 
-    Q_CHECK_PTR(parameters); 
-    return parameters->getWavelengthPattern(); 
-}
 
+void Spinsystem::updateClusters(SwendsenWang& clusters, const unsigned int rowBegin, const unsigned int rowEnd, Barrier& barrier, std::vector<VectorEngine>& engines, long& interactionChange, long& magneticChange)
+{
+    // Swendsen-Wang update, called by every thread with its own rows [rowBegin, rowEnd)
+    // the changes of interaction and spin sum are accumulated, the Hamiltonian is left alone
 
-int Spinsystem::getWavelength() const 
-{ 
-    Q_CHECK_PTR(parameters); 
-    return parameters->getWavelength(); 
+    clusters.sweep(spins, rowBegin, rowEnd, barrier, engines, interactionChange, magneticChange);
 }
 
 
-void Spinsystem::setParameters(BaseParametersWidget* prms)
+
+double Spinsystem::getMagnetisation() const
 {
-    qDebug() << __PRETTY_FUNCTION__;
+    /* Aufgabe 1.5:
+     *
+     * input:    /
+     * return:   Mittlere Magnetisierung M
+     * Funktion: Berechnung der mittleren Magnetisierung M für die aktuelle Spin-
+     *           konfiguration.  
+     */
 
-    Q_CHECK_PTR(prms);
-    parameters = prms;
-    Q_CHECK_PTR(parameters);
+    return static_cast<double>(spinSum) / spins.size();
 }
 
 
-void Spinsystem::resetParameters()
+
+long Spinsystem::getInterfaceLength() const
 {
-    qDebug() << __PRETTY_FUNCTION__;
+    // number of bonds between opposite spins, links of a spin to itself are no bonds
 
-    computeHamiltonian();
-    Logger::getInstance().debug_new_line("[spinsystem]", "resetting parameters ... new initial H = ", Hamiltonian);
+    const long bonds = static_cast<long>(spins.size()) * (4 - spins.getSelfLinks()) / 2;
+    return (bonds - interactionSum) / 2;
 }
 
 
-void Spinsystem::setup()
-{
-    // setup of the spinsystem: add all spins, add corresponding neighbours to each spin, set all spintypes randomly
 
-    qDebug() << __PRETTY_FUNCTION__;
 
-    spins.clear();
-    lastFlipped.clear();
+/*
+ * DER HIER FOLGENDE TEIL DER KLASSE NICHT RELEVANT FUER 
+ * DIE IMPLEMENTIERUNGSAUFGABEN UND KANN IGNORIERT WERDEN !
+ */
+
+void Spinsystem::setParameters(const Parameters& prms)
+{
+    parameters = prms;
 
     // some safety checks:
     if( getSpinExchange() )
     {
-        if( parameters->getWidth() % 2 != 0 )
+        if( parameters.width % 2 != 0 )
         {
-            parameters->setWidth(parameters->getWidth()+1);
-            qInfo() << "Remember: system size must be an even number if system is constrained!";
+            parameters.width += 1;
+            Logger::getInstance().write_new_line("[spinsystem]", "Remember: system size must be an even number if system is constrained!");
         }
-        if( parameters->getHeight() % 2 != 0 )
+        if( parameters.height % 2 != 0 )
         {
-            parameters->setHeight(parameters->getHeight()+1);
-            qInfo() << "Remember: system size must be an even number if system is constrained!";
+            parameters.height += 1;
+            Logger::getInstance().write_new_line("[spinsystem]", "Remember: system size must be an even number if system is constrained!");
         }
     }
+}
 
-    auto width  = getWidth();
-    auto height = getHeight();
-    auto totalnumber = width * height;
-
-    // create spins:
-    for(unsigned int i=0; i<totalnumber; ++i)
-        spins.emplace_back(i, +1);
-
-    // set neighbours:
-    Logger::getInstance().debug_new_line("[spinsystem]", "system setup: setting neighbours for", getWidth(), "*", getHeight(), "system");
-    for(auto& s: spins)
-    {
-        std::vector<std::reference_wrapper<Spin> > Nrefs;
-        unsigned int Nid;
-        const unsigned int id = s.getID();
 
-        {
-            // up
-            Nid = ((long)id - static_cast<long>(width)) < 0 ? id - width + totalnumber : id - width;
-            assert( Nid < spins.size() );
-            if( Nid != id )
-                Nrefs.push_back( std::ref(spins[Nid]) );
-        }
+void Spinsystem::resetParameters()
+{
+    computeHamiltonian();
+    resetInterface();
+    Logger::getInstance().debug_new_line("[spinsystem]", "resetting parameters ... new initial H = ", Hamiltonian);
+}
 
-        {
-            // right
-            Nid = (id + 1) % width == 0  ? id + 1 - width : id + 1;
-            assert( Nid < spins.size() );
-            if( Nid != id )
-                Nrefs.push_back( std::ref(spins[Nid]) );
-        }
 
-        {
-            // below
-            Nid = id + width >= totalnumber ? id + width - totalnumber : id + width;
-            assert( Nid < spins.size() );
-            if( Nid != id )
-                 Nrefs.push_back( std::ref(spins[Nid]) );
-        }
+void Spinsystem::setup(enhance::Engine& engine)
+{
+    // setup of the spinsystem: allocate all spins, set all spintypes randomly
 
-        {
-            // left
-            Nid = id % width == 0  ? id - 1 + width : id - 1;
-            assert( Nid < spins.size() );
-            if( Nid != id )
-                 Nrefs.push_back( std::ref(spins[Nid]) );
-        }
+    lastMove = Move {};
 
-        s.setNeighbours(Nrefs);
-        Logger::getInstance().debug_new_line("            ",  "spin", s.getID(), "has neighbours :");
-        std::for_each( std::begin(s.getNeighbours()), std::end(s.getNeighbours()), [](auto& N){ Logger::getInstance().debug( N.get().getID()," "); } );
-    }
+    // create spins, neighbours follow from the position on the lattice:
+    Logger::getInstance().debug_new_line("[spinsystem]", "system setup: allocating", getWidth(), "*", getHeight(), "system");
+    spins.resize(getWidth(), getHeight());
     
     // set spin types:
     if( getWavelengthPattern() )
     {
-        resetSpinsCosinus( getWavelength() );
+        resetSpinsCosinus( getWavelength(), engine );
     }
     else
     {
-        resetSpins();
+        resetSpins(engine);
     }
 
 }
 
 
-void Spinsystem::resetSpins() 
+void Spinsystem::resetSpins(enhance::Engine& engine)
 {
     // randomly set types of all spins new
 
-    qDebug() << __PRETTY_FUNCTION__;
-
     int random;
-    if( ! getSpinExchange() ) // initialise spins randomly
+    if( ! getSpinExchange() ) // initialise spins randomly, one random bit per spin
     {
-        for( auto& s: spins )
+        std::vector<std::uint64_t> bits( (spins.size() + 63) / 64 );
+        enhance::generate(engine, bits.data(), bits.data() + bits.size());
+        for(unsigned int id=0; id<spins.size(); ++id)
         {
-            random = enhance::random_int(0,1);
-            s.setType( random == 1 ? +1 : -1 );
+            spins.setType( id, (bits[id/64] >> (id%64)) & 1 ? +1 : -1 );
         }
     }      
     else  // constrained to specific up-spin to down-spin ratio
     {
         Logger::getInstance().debug_new_line("[spinsystem]", "ratio =", getRatio(), ", results in", static_cast<unsigned int>(getRatio() * spins.size()), " down spins.");
-        for( auto& s: spins ) 
-            s.setType( +1 );
+        for(unsigned int id=0; id<spins.size(); ++id)
+            spins.setType( id, +1 );
         for(unsigned int i=0; i<static_cast<unsigned int>( getRatio() * spins.size()); ++i)
         {
             do
             {
-                random = enhance::random_int(0, spins.size()-1);
+                random = enhance::bounded(engine, spins.size());
             }
-            while( spins[random].getType() == -1 );
-            spins[random].setType(-1);
+            while( spins.getType(random) == -1 );
+            spins.setType(random, -1);
         }
     }
 
     // clear / reset all vectors: 
-    lastFlipped.clear();
+    lastMove = Move {};
     
     // calculate initial Hamiltonian:
     computeHamiltonian();
+    resetInterface();
     Logger::getInstance().debug_new_line("[spinsystem]", "resetting spins randomly... new initial H =", Hamiltonian);
     Logger::getInstance().debug_new_line(getStringOfSystem());
 
 }
 
 
-void Spinsystem::resetSpinsCosinus(const double k) 
+void Spinsystem::resetSpinsCosinus(const double k, enhance::Engine& engine)
 {
     // set types of all spins new according to c(x) = cos(kx) 
 
-    qDebug() << __PRETTY_FUNCTION__;
-
     int random;
     
     unsigned int totNrDownSpins = 0;
-    for( auto& s: spins ) 
-        s.setType( +1 );
+    for(unsigned int id=0; id<spins.size(); ++id)
+        spins.setType( id, +1 );
     for(unsigned int i = 0; i<getWidth(); ++i)
     {
         double ratio = ((0.5*std::cos(k*(2*M_PI/getWidth())*static_cast<double>(i+0.5)) + 1) / 2);
@@ -404,18 +408,19 @@ void Spinsystem::resetSpinsCosinus(const double k)
         {
             do
             {
-                random = enhance::random_int(i*getWidth(), (i+1)*getWidth() - 1);
+                random = i*getWidth() + enhance::bounded(engine, getWidth());
             }
-            while( spins[random].getType() == -1 );
-            spins[random].setType(-1);
+            while( spins.getType(random) == -1 );
+            spins.setType(random, -1);
         }
     }
 
     // clear / reset all vectors: 
-    lastFlipped.clear();
+    lastMove = Move {};
     
     // calculate initial Hamiltonian:
     computeHamiltonian();
+    resetInterface();
     Logger::getInstance().debug_new_line("[spinsystem]", "resetting spins with cos(", getWavelength(),"y ) pattern ... new initial H =", Hamiltonian);
     Logger::getInstance().debug_new_line("[spinsystem]", "# of down spins:", totNrDownSpins);
     Logger::getInstance().debug_new_line(getStringOfSystem());
@@ -423,14 +428,78 @@ void Spinsystem::resetSpinsCosinus(const double k)
 }
 
 
+void Spinsystem::setSpins(const std::vector<Lattice::spin_type>& types)
+{
+    // take over a given spin configuration, e.g. one replica of the multi-spin system
+
+    assert( types.size() == spins.size() );
+
+    for(unsigned int id=0; id<spins.size(); ++id)
+        spins.setType( id, types[id] );
+
+    lastMove = Move {};
+    computeHamiltonian();
+    resetInterface();
+}
+
+
+void Spinsystem::swapSpins(Spinsystem& other)
+{
+    // exchange configurations with a system of the same size, e.g. in parallel tempering,
+    // the observables go along with the spins, only the Hamiltonian depends on J and B
+
+    assert( spins.size() == other.spins.size() );
+
+    std::swap(spins, other.spins);
+    std::swap(interactionSum, other.interactionSum);
+    std::swap(spinSum, other.spinSum);
+    std::swap(interface, other.interface);
+    lastMove = Move {};
+    other.lastMove = Move {};
+
+    addChanges(0, 0);
+    other.addChanges(0, 0);
+}
+
+
+void Spinsystem::save(BinaryWriter& out) const
+{
+    // one bit per spin, followed by the interface in its current order
+
+    std::vector<std::uint64_t> bits(spins.packedSize());
+    spins.pack(bits.data());
+    out.write<std::uint64_t>(spins.size());
+    out.write(bits);
+    interface.save(out);
+}
+
+
+void Spinsystem::load(BinaryReader& in)
+{
+    // the lattice has to be set up with the same size already
+
+    const auto size = in.get<std::uint64_t>();
+    std::vector<std::uint64_t> bits;
+    in.read(bits);
+    if( size != spins.size() || bits.size() != spins.packedSize() )
+        throw std::runtime_error("spin configuration does not match the lattice");
+
+    spins.unpack(bits.data());
+    lastMove = Move {};
+    computeHamiltonian();
+    resetInterface();
+    interface.load(in);
+}
+
+
 void Spinsystem::print(std::ostream & stream) const
 {
     // print spins to stream
 
-    for( const auto& s: spins )
+    for(unsigned int id=0; id<spins.size(); ++id)
     {
-        stream << ( s.getType() == -1 ? "-" : "+" )
-        << ( (static_cast<unsigned int>(s.getID() + 1)) % getWidth() == 0 ? '\n' : ' ');
+        stream << ( spins.getType(id) == -1 ? "-" : "+" )
+        << ( (id + 1) % getWidth() == 0 ? '\n' : ' ');
     }
 }
 
@@ -446,16 +515,16 @@ std::string Spinsystem::getStringOfSystem() const
 }
 
 
-double Spinsystem::distance(const Spin& _spin1, const Spin& _spin2) const
+double Spinsystem::distance(const unsigned int _id1, const unsigned int _id2) const
 {
     // compute distance between spins _spin1 and _spin2
 
     int a, b, c, d, x, y;
 
-    a = _spin1.getID() % getWidth();
-    b = _spin1.getID() / getWidth();
-    c = _spin2.getID() % getWidth();
-    d = _spin2.getID() / getWidth();
+    a = _id1 % getWidth();
+    b = _id1 / getWidth();
+    c = _id2 % getWidth();
+    d = _id2 / getWidth();
 
     x = (std::abs(c - a) <= static_cast<int>(getWidth()/2) ? std::abs(c - a) : std::abs(c - a) - getWidth());
     y = (std::abs(d - b) <= static_cast<int>(getHeight()/2) ? std::abs(d - b) : std::abs(d - b) - getHeight());
@@ -475,18 +544,18 @@ Histogram<double> Spinsystem::computeCorrelation() const
 
     // first: <S(0)S(r)>:
     double maxDist = ( getWidth() >= getHeight() ? (double) getWidth() : (double) getHeight() )/2  + binWidth/2;
-    for( auto& s1 : spins )
+    for(unsigned int s1=0; s1<spins.size(); ++s1)
     {
-        for( auto& s2 : spins )
+        for(unsigned int s2=0; s2<spins.size(); ++s2)
         {
-            if( s1.getID() != s2.getID() )
+            if( s1 != s2 )
             {
                 double dist = distance( s1,  s2);
                 if( dist < maxDist )
                 {
-                    correlation.add_data( dist, s1.getType() == s2.getType() ? 1 : -1);
+                    correlation.add_data( dist, spins.getType(s1) == spins.getType(s2) ? 1 : -1);
                     counter.add_data( dist );
-                    Logger::getInstance().debug_new_line("            ", "correlating ", s1.getID(), " with ", s2.getID()," : ", s1.getType() == s2.getType() ? 1 : -1);
+                    Logger::getInstance().debug_new_line("            ", "correlating ", s1, " with ", s2," : ", spins.getType(s1) == spins.getType(s2) ? 1 : -1);
                     Logger::getInstance().debug("   distance ", dist);
                 }
             }
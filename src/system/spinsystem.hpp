@@ -1,13 +1,21 @@
 #pragma once
 
-#include "spin.hpp"
+#include "lattice.hpp"
+#include "parameters.hpp"
+#include "acceptancetable.hpp"
+#include "sublatticekernel.hpp"
+#include "wolffcluster.hpp"
+#include "swendsenwang.hpp"
+#include "interfacebonds.hpp"
+#include "nfoldway.hpp"
 #include "lib/enhance.hpp"
 #include "utility/histogram.hpp"
 #include "utility/logger.hpp"
-#include "gui/parameters/base_parameters_widget.hpp"
 #include <ostream>
 #include <string>
 #include <sstream>
+#include <numeric>
+#include <algorithm>
 
 
 
@@ -15,21 +23,58 @@ class Spinsystem
 {
 private:
     double Hamiltonian {0};
-    std::vector<Spin> spins {};
+    Lattice spins {};
+
+    // additive observables, kept up to date with every flip like the Hamiltonian
+    long interactionSum {0};                    // sum_<ij> s_i*s_j
+    long spinSum {0};                           // sum_i s_i
     
+public:
+    // a single spin flip or an exchange of two neighbouring spins, drawn without changing the system
+    struct Move
+    {
+        unsigned int first {0};
+        unsigned int second {0};
+        unsigned int size {0};                  // number of flipped spins, 0 if there is nothing to flip
+        int interactionChange {0};              // change of sum_<ij> s_i*s_j
+        int magneticChange {0};                 // change of sum_i s_i
+        double proposalRatio {1};               // probability of the reverse over the forward proposal
+    };
+
+private:
     // Fuer Aufgabe 1.4:
-    std::vector<unsigned int> lastFlipped {};   // contains spin-ID's of flipped Spins from last call to flip()
+    Move lastMove {};                           // move of the last call to flip()
+
+    InterfaceBonds interface {};                // anti-aligned bonds, only kept in spin-exchange mode
 
     void   computeHamiltonian();
-    double localEnergyInteraction(const Spin&) const;
-    double localEnergyMagnetic(const Spin&) const;
+    void   resetInterface();
+    double localEnergyInteraction(const unsigned int) const;
+    double localEnergyMagnetic(const unsigned int) const;
 
 public:
-    void flip();
+    Move propose(enhance::Engine&) const;
+    Move propose(const unsigned int) const;
+    void commit(const Move&);
+
+    void flip(enhance::Engine&);
+    void flip(const unsigned int);
     void flip_back();
+    void heatBath(const unsigned int, const AcceptanceTable&, enhance::Engine&);
+
+    void updateSublattice(const unsigned int, const unsigned int, const unsigned int, const SublatticeKernel::Thresholds&, VectorEngine&, long&, long&);
+    void addChanges(const long, const long);
+    bool updateCluster(WolffCluster&, enhance::Engine&);
+    unsigned long updateContinuousTime(NFoldWay&, const double, enhance::Engine&);
+    void updateClusters(SwendsenWang&, const unsigned int, const unsigned int, Barrier&, std::vector<VectorEngine>&, long&, long&);
 
     double getMagnetisation() const;
     auto   getHamiltonian() const { return Hamiltonian; }
+    auto   getInteractionSum() const { return interactionSum; }
+    auto   getSpinSum() const { return spinSum; }
+    long   getInterfaceLength() const;
+    auto   getLastInteractionChange() const { return lastMove.interactionChange; }
+    auto   getLastMagneticChange() const { return lastMove.magneticChange; }
 
 
 /* 
@@ -39,11 +84,11 @@ public:
  * JEDOCH NICHT BEKANNT SEIN
  */ 
 public:
-    unsigned long getHeight() const;         // returns system height
-    unsigned long getWidth() const;          // returns system width
-    double        getInteraction() const;    // returns J
-    double        getMagnetic()  const;      // returns B
-    bool          getSpinExchange()  const;  // returns true if spin-exchange mode, else false
+    unsigned long getHeight() const       { return parameters.height; }       // returns system height
+    unsigned long getWidth() const        { return parameters.width; }        // returns system width
+    double        getInteraction() const  { return parameters.interaction; }  // returns J
+    double        getMagnetic()  const    { return parameters.magnetic; }     // returns B
+    bool          getSpinExchange()  const { return parameters.constrained; } // returns true if spin-exchange mode, else false
 
     std::string getStringOfSystem() const;   // returns a string with current spin configuration
 
@@ -53,8 +98,8 @@ public:
  * DIE IMPLEMENTIERUNGSAUFGABEN UND KANN IGNORIERT WERDEN 
  */ 
 private:
-    BaseParametersWidget* parameters = Q_NULLPTR;
-    double distance(const Spin&, const Spin&) const;
+    Parameters parameters {};
+    double distance(const unsigned int, const unsigned int) const;
 
 public:
     Spinsystem()  {};
@@ -62,17 +107,23 @@ public:
     Spinsystem(const Spinsystem&) = delete;
     void operator=(const Spinsystem&) = delete;
 
-    inline const auto& getSpins() const { return spins; };
+    inline const auto& getLattice() const { return spins; };
 
-    double        getRatio() const;              
-    bool          getWavelengthPattern() const; 
-    int           getWavelength() const;   
+    double        getRatio() const             { return parameters.ratio; }
+    bool          getWavelengthPattern() const { return parameters.wavelengthPattern; }
+    int           getWavelength() const        { return parameters.wavelength; }
+    const auto&   getParameters() const        { return parameters; }
 
-    void setParameters(BaseParametersWidget*);
-    void setup();
+    void setParameters(const Parameters&);
+    void setup(enhance::Engine&);
     void resetParameters();
-    void resetSpins();
-    void resetSpinsCosinus(const double);
+    void resetSpins(enhance::Engine&);
+    void resetSpinsCosinus(const double, enhance::Engine&);
+    void setSpins(const std::vector<Lattice::spin_type>&);
+    void swapSpins(Spinsystem&);
+
+    void save(BinaryWriter&) const;
+    void load(BinaryReader&);
 
     Histogram<double> computeCorrelation() const;
     Histogram<double> computeStructureFunction(const Histogram<double>) const;
@@ -82,5 +133,3 @@ public:
 
 };
 
-
-
@@ -0,0 +1,345 @@
+#include "sublatticekernel.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <immintrin.h>
+    #define SUBLATTICE_KERNEL_X86
+#endif
+
+
+
+static inline void updateSite(Lattice::spin_type* row, const Lattice::spin_type* up, const Lattice::spin_type* below, const unsigned int width, const unsigned int column, const int selfLinks, const SublatticeKernel::Thresholds& thresholds, VectorEngine& engine, long& interactionChange, long& magneticChange)
+{
+    // metropolis update of a single site, neighbours are found with periodic boundaries
+
+    const unsigned int right = (column == width - 1 ? 0 : column + 1);
+    const unsigned int left = (column == 0 ? width - 1 : column - 1);
+    const int spin = row[column];
+    const int local = spin * (up[column] + row[right] + below[column] + row[left]);
+    const std::uint64_t threshold = thresholds[local + 4 + (spin < 0)];
+    if( threshold == AcceptanceTable::always || engine() < threshold )
+    {
+        row[column] = -spin;
+        interactionChange += -2 * (local - selfLinks);
+        magneticChange += -2 * spin;
+    }
+}
+
+
+
+static void updateScalar(Lattice& lattice, const unsigned int colour, const unsigned int rowBegin, const unsigned int rowEnd, const SublatticeKernel::Thresholds& thresholds, VectorEngine& engine, long& interactionChange, long& magneticChange)
+{
+    Lattice::spin_type* types = lattice.data();
+    const unsigned int width = lattice.getWidth();
+    const unsigned int height = lattice.getHeight();
+    for(unsigned int row = rowBegin; row < rowEnd; ++row)
+    {
+        Lattice::spin_type* current = types + row*width;
+        const Lattice::spin_type* up = types + (row == 0 ? height - 1 : row - 1)*width;
+        const Lattice::spin_type* below = types + (row == height - 1 ? 0 : row + 1)*width;
+        for(unsigned int column = (row + colour) % 2; column < width; column += 2)
+            updateSite(current, up, below, width, column, lattice.getSelfLinks(), thresholds, engine, interactionChange, magneticChange);
+    }
+}
+
+
+
+#ifdef SUBLATTICE_KERNEL_X86
+
+// Both vector kernels work on chunks of a row starting at column 1, so left and
+// right neighbours are plain unaligned loads. Columns 0 and the tail of the row
+// are handled by updateSite(). Chunks also load sites of the colour which is
+// being updated by other threads, their results are masked out and never used.
+
+// shuffle pattern collecting the even (first half) or odd (second half) bytes
+// of each 128 bit lane in its lower 8 bytes
+alignas(64) static const std::int8_t compactPattern[2][64] =
+{
+    { 0,2,4,6,8,10,12,14, -1,-1,-1,-1,-1,-1,-1,-1,  0,2,4,6,8,10,12,14, -1,-1,-1,-1,-1,-1,-1,-1,
+      0,2,4,6,8,10,12,14, -1,-1,-1,-1,-1,-1,-1,-1,  0,2,4,6,8,10,12,14, -1,-1,-1,-1,-1,-1,-1,-1 },
+    { 1,3,5,7,9,11,13,15, -1,-1,-1,-1,-1,-1,-1,-1,  1,3,5,7,9,11,13,15, -1,-1,-1,-1,-1,-1,-1,-1,
+      1,3,5,7,9,11,13,15, -1,-1,-1,-1,-1,-1,-1,-1,  1,3,5,7,9,11,13,15, -1,-1,-1,-1,-1,-1,-1,-1 }
+};
+
+
+
+__attribute__((target("avx2")))
+static inline __m256i nextAVX2(__m256i& s0, __m256i& s1, __m256i& s2, __m256i& s3)
+{
+    // xoshiro256+ step of four lanes
+
+    const __m256i result = _mm256_add_epi64(s0, s3);
+    const __m256i t = _mm256_slli_epi64(s1, 17);
+    s2 = _mm256_xor_si256(s2, s0);
+    s3 = _mm256_xor_si256(s3, s1);
+    s1 = _mm256_xor_si256(s1, s2);
+    s0 = _mm256_xor_si256(s0, s3);
+    s2 = _mm256_xor_si256(s2, t);
+    s3 = _mm256_or_si256(_mm256_slli_epi64(s3, 45), _mm256_srli_epi64(s3, 19));
+    return result;
+}
+
+
+
+__attribute__((target("avx2")))
+static void updateAVX2(Lattice& lattice, const unsigned int colour, const unsigned int rowBegin, const unsigned int rowEnd, const SublatticeKernel::Thresholds& thresholds, VectorEngine& engine, long& interactionChange, long& magneticChange)
+{
+    // 32 sites per chunk, 16 of them of the current colour
+
+    constexpr unsigned int chunk = 32;
+
+    Lattice::spin_type* types = lattice.data();
+    const unsigned int width = lattice.getWidth();
+    const unsigned int height = lattice.getHeight();
+    const int selfLinks = lattice.getSelfLinks();
+    const long long* table = reinterpret_cast<const long long*>(thresholds.data());
+
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i four = _mm256_set1_epi8(4);
+    const __m256i all = _mm256_set1_epi64x(-1);
+    const __m256i signBit = _mm256_set1_epi64x(std::numeric_limits<long long>::min());
+    alignas(32) std::int8_t locals[chunk];
+
+    std::uint64_t* state = engine.state.data();
+    for(unsigned int row = rowBegin; row < rowEnd; ++row)
+    {
+        Lattice::spin_type* current = types + row*width;
+        const Lattice::spin_type* up = types + (row == 0 ? height - 1 : row - 1)*width;
+        const Lattice::spin_type* below = types + (row == height - 1 ? 0 : row + 1)*width;
+
+        // offset of the first site of this colour in every chunk
+        const unsigned int parity = (row + colour + 1) % 2;
+        const __m256i compact = _mm256_load_si256(reinterpret_cast<const __m256i*>(compactPattern[parity]));
+
+        __m256i s0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state));
+        __m256i s1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state + VectorEngine::lanes));
+        __m256i s2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state + 2*VectorEngine::lanes));
+        __m256i s3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state + 3*VectorEngine::lanes));
+
+        unsigned int column = 1;
+        for( ; column + chunk < width; column += chunk)
+        {
+            const __m256i spin  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(current + column));
+            const __m256i left  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(current + column - 1));
+            const __m256i right = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(current + column + 1));
+            const __m256i upper = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(up + column));
+            const __m256i lower = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(below + column));
+
+            // s_i*sum_j s_j and class index of every site
+            const __m256i sum = _mm256_add_epi8(_mm256_add_epi8(left, right), _mm256_add_epi8(upper, lower));
+            const __m256i local = _mm256_sign_epi8(sum, spin);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(locals), local);
+            const __m256i index = _mm256_sub_epi8(_mm256_add_epi8(local, four), _mm256_cmpgt_epi8(zero, spin));
+
+            // class indices of the 16 sites of this colour in the lower 128 bits
+            __m128i indices = _mm256_castsi256_si128(_mm256_permute4x64_epi64(_mm256_shuffle_epi8(index, compact), _MM_SHUFFLE(3,1,2,0)));
+
+            for(unsigned int group=0; group<4; ++group)
+            {
+                const __m256i threshold = _mm256_i32gather_epi64(table, _mm_cvtepu8_epi32(indices), 8);
+                const __m256i random = nextAVX2(s0, s1, s2, s3);
+                const __m256i accepted = _mm256_or_si256(_mm256_cmpeq_epi64(threshold, all),
+                                                         _mm256_cmpgt_epi64(_mm256_xor_si256(threshold, signBit), _mm256_xor_si256(random, signBit)));
+                indices = _mm_srli_si128(indices, 4);
+
+                unsigned int mask = _mm256_movemask_pd(_mm256_castsi256_pd(accepted));
+                while( mask != 0 )
+                {
+                    const unsigned int offset = parity + 2*(4*group + __builtin_ctz(mask));
+                    const int s = current[column + offset];
+                    current[column + offset] = -s;
+                    interactionChange += -2 * (locals[offset] - selfLinks);
+                    magneticChange += -2 * s;
+                    mask &= mask - 1;
+                }
+            }
+        }
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(state), s0);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(state + VectorEngine::lanes), s1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(state + 2*VectorEngine::lanes), s2);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(state + 3*VectorEngine::lanes), s3);
+
+        // first column and remaining tail
+        if( (row + colour) % 2 == 0 )
+            updateSite(current, up, below, width, 0, selfLinks, thresholds, engine, interactionChange, magneticChange);
+        for(column += (row + colour + column) % 2; column < width; column += 2)
+            updateSite(current, up, below, width, column, selfLinks, thresholds, engine, interactionChange, magneticChange);
+    }
+}
+
+
+
+// GCC 12 warns about the undefined pass-through operand (__Y) of its own AVX-512 intrinsics
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+__attribute__((target("avx2,avx512f,avx512bw")))
+static inline __m512i nextAVX512(__m512i& s0, __m512i& s1, __m512i& s2, __m512i& s3)
+{
+    // xoshiro256+ step of eight lanes
+
+    const __m512i result = _mm512_add_epi64(s0, s3);
+    const __m512i t = _mm512_slli_epi64(s1, 17);
+    s2 = _mm512_xor_si512(s2, s0);
+    s3 = _mm512_xor_si512(s3, s1);
+    s1 = _mm512_xor_si512(s1, s2);
+    s0 = _mm512_xor_si512(s0, s3);
+    s2 = _mm512_xor_si512(s2, t);
+    s3 = _mm512_rol_epi64(s3, 45);
+    return result;
+}
+
+
+
+__attribute__((target("avx2,avx512f,avx512bw")))
+static void updateAVX512(Lattice& lattice, const unsigned int colour, const unsigned int rowBegin, const unsigned int rowEnd, const SublatticeKernel::Thresholds& thresholds, VectorEngine& engine, long& interactionChange, long& magneticChange)
+{
+    // 64 sites per chunk, 32 of them of the current colour
+
+    constexpr unsigned int chunk = 64;
+
+    Lattice::spin_type* types = lattice.data();
+    const unsigned int width = lattice.getWidth();
+    const unsigned int height = lattice.getHeight();
+    const int selfLinks = lattice.getSelfLinks();
+    const long long* table = reinterpret_cast<const long long*>(thresholds.data());
+
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i one = _mm512_set1_epi8(1);
+    const __m512i four = _mm512_set1_epi8(4);
+    const __m512i all = _mm512_set1_epi64(-1);
+    const __m512i lowerHalves = _mm512_set_epi64(7, 5, 3, 1, 6, 4, 2, 0);
+    alignas(64) std::int8_t locals[chunk];
+
+    std::uint64_t* state = engine.state.data();
+    for(unsigned int row = rowBegin; row < rowEnd; ++row)
+    {
+        Lattice::spin_type* current = types + row*width;
+        const Lattice::spin_type* up = types + (row == 0 ? height - 1 : row - 1)*width;
+        const Lattice::spin_type* below = types + (row == height - 1 ? 0 : row + 1)*width;
+
+        // offset of the first site of this colour in every chunk
+        const unsigned int parity = (row + colour + 1) % 2;
+        const __m512i compact = _mm512_load_si512(compactPattern[parity]);
+
+        __m512i s0 = _mm512_loadu_si512(state);
+        __m512i s1 = _mm512_loadu_si512(state + VectorEngine::lanes);
+        __m512i s2 = _mm512_loadu_si512(state + 2*VectorEngine::lanes);
+        __m512i s3 = _mm512_loadu_si512(state + 3*VectorEngine::lanes);
+
+        unsigned int column = 1;
+        for( ; column + chunk < width; column += chunk)
+        {
+            const __m512i spin  = _mm512_loadu_si512(current + column);
+            const __m512i left  = _mm512_loadu_si512(current + column - 1);
+            const __m512i right = _mm512_loadu_si512(current + column + 1);
+            const __m512i upper = _mm512_loadu_si512(up + column);
+            const __m512i lower = _mm512_loadu_si512(below + column);
+
+            // s_i*sum_j s_j and class index of every site
+            const __m512i sum = _mm512_add_epi8(_mm512_add_epi8(left, right), _mm512_add_epi8(upper, lower));
+            const __mmask64 down = _mm512_movepi8_mask(spin);
+            const __m512i local = _mm512_mask_sub_epi8(sum, down, zero, sum);
+            _mm512_store_si512(locals, local);
+            const __m512i shifted = _mm512_add_epi8(local, four);
+            const __m512i index = _mm512_mask_add_epi8(shifted, down, shifted, one);
+
+            // class indices of the 32 sites of this colour in the lower 256 bits
+            const __m256i indices = _mm512_castsi512_si256(_mm512_permutexvar_epi64(lowerHalves, _mm512_shuffle_epi8(index, compact)));
+            const __m128i lowerIndices = _mm256_castsi256_si128(indices);
+            const __m128i upperIndices = _mm256_extracti128_si256(indices, 1);
+
+            for(unsigned int group=0; group<4; ++group)
+            {
+                const __m128i half = group < 2 ? lowerIndices : upperIndices;
+                const __m128i bytes = group % 2 == 0 ? half : _mm_srli_si128(half, 8);
+                const __m512i threshold = _mm512_i32gather_epi64(_mm256_cvtepu8_epi32(bytes), table, 8);
+                const __m512i random = nextAVX512(s0, s1, s2, s3);
+
+                unsigned int mask = _mm512_cmplt_epu64_mask(random, threshold) | _mm512_cmpeq_epi64_mask(threshold, all);
+                while( mask != 0 )
+                {
+                    const unsigned int offset = parity + 2*(8*group + __builtin_ctz(mask));
+                    const int s = current[column + offset];
+                    current[column + offset] = -s;
+                    interactionChange += -2 * (locals[offset] - selfLinks);
+                    magneticChange += -2 * s;
+                    mask &= mask - 1;
+                }
+            }
+        }
+
+        _mm512_storeu_si512(state, s0);
+        _mm512_storeu_si512(state + VectorEngine::lanes, s1);
+        _mm512_storeu_si512(state + 2*VectorEngine::lanes, s2);
+        _mm512_storeu_si512(state + 3*VectorEngine::lanes, s3);
+
+        // first column and remaining tail
+        if( (row + colour) % 2 == 0 )
+            updateSite(current, up, below, width, 0, selfLinks, thresholds, engine, interactionChange, magneticChange);
+        for(column += (row + colour + column) % 2; column < width; column += 2)
+            updateSite(current, up, below, width, column, selfLinks, thresholds, engine, interactionChange, magneticChange);
+    }
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
+
+
+
+SublatticeKernel::Thresholds SublatticeKernel::thresholds(const AcceptanceTable& table, const int selfLinks)
+{
+    // a flip changes sum_<ij> s_i*s_j by -2*(local - selfLinks) and sum_i s_i by -2*s_i
+
+    Thresholds result {};
+    for(int k=0; k<static_cast<int>(result.size()); ++k)
+    {
+        const int spin = (k % 2 == 0 ? +1 : -1);
+        const int local = (k & ~1) - 4;
+        result[k] = table.threshold(-2 * (local - selfLinks), -2 * spin);
+    }
+    return result;
+}
+
+
+
+void SublatticeKernel::update(Lattice& lattice, const unsigned int colour, const unsigned int rowBegin, const unsigned int rowEnd, const Thresholds& thresholds, VectorEngine& engine, long& interactionChange, long& magneticChange)
+{
+    selected().function(lattice, colour, rowBegin, rowEnd, thresholds, engine, interactionChange, magneticChange);
+}
+
+
+
+const char* SublatticeKernel::name()
+{
+    return selected().name;
+}
+
+
+
+SublatticeKernel::Selection SublatticeKernel::select()
+{
+    // widest instruction set supported by the running CPU
+
+    #ifdef SUBLATTICE_KERNEL_X86
+        __builtin_cpu_init();
+        if( __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") )
+            return { &updateAVX512, "avx512" };
+        if( __builtin_cpu_supports("avx2") )
+            return { &updateAVX2, "avx2" };
+    #endif
+    return { &updateScalar, "scalar" };
+}
+
+
+
+const SublatticeKernel::Selection& SublatticeKernel::selected()
+{
+    static const Selection selection = select();
+    return selection;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "lattice.hpp"
+#include "acceptancetable.hpp"
+#include "vectorengine.hpp"
+#include <array>
+#include <cstdint>
+
+
+
+// Metropolis update of one checkerboard colour in a band of rows.
+// The best kernel supported by the CPU is chosen once at runtime:
+// AVX-512 and AVX2 work on a whole chunk of a row per instruction,
+// the scalar kernel visits one site after the other.
+// All kernels accept with the same probabilities, but consume random numbers
+// in a different order, so their results agree only statistically.
+class SublatticeKernel
+{
+public:
+    // acceptance thresholds of the site classes k = s_i*sum_j s_j + 4 + (s_i < 0)
+    typedef std::array<std::uint64_t, 10> Thresholds;
+
+    typedef void (*Function)(Lattice&, const unsigned int, const unsigned int, const unsigned int, const Thresholds&, VectorEngine&, long&, long&);
+
+    static Thresholds thresholds(const AcceptanceTable&, const int);
+
+    // colour, first row, end row, thresholds, engine, accumulated dI, accumulated dM
+    static void update(Lattice&, const unsigned int, const unsigned int, const unsigned int, const Thresholds&, VectorEngine&, long&, long&);
+    static const char* name();
+
+private:
+    struct Selection
+    {
+        Function function;
+        const char* name;
+    };
+
+    static Selection select();
+    static const Selection& selected();
+};
@@ -0,0 +1,116 @@
+#include "sweepexecutor.hpp"
+
+
+
+void SweepExecutor::setup(const std::vector<Parameters>& _points)
+{
+    // one parameter snapshot per sweep point, the threads of the first one size the pool
+
+    points = _points;
+    lines.assign(points.size(), std::string());
+    threads = points.empty() || points.front().threads == 0 ? std::thread::hardware_concurrency() : points.front().threads;
+    threads = std::max(1u, std::min<unsigned int>(threads, points.size()));
+    completed.store(0);
+    aborted.store(false);
+}
+
+
+
+void SweepExecutor::run()
+{
+    // blocks until every point is done or the sweep was aborted,
+    // the first failing point stops the others and its exception is rethrown here
+
+    WorkStealingPool pool(threads);
+    for(std::size_t i=0; i<points.size(); ++i)
+    {
+        pool.submit([this, i]
+        {
+            try
+            {
+                runPoint(i);
+            }
+            catch(...)
+            {
+                aborted.store(true);
+                throw;
+            }
+        });
+    }
+    pool.wait();
+}
+
+
+
+void SweepExecutor::runPoint(const std::size_t i)
+{
+    // equilibration and production of a single point, the threads are spent on the points
+
+    if( aborted.load() )
+        return;
+
+    Parameters prms = points[i];
+    prms.threads = 1;
+
+    MonteCarloHost host(i+1);
+    host.setParameters(prms);
+    host.setup();
+    host.setTrajectoryFile(outputFile(prms, "trajectory", std::to_string(i)));
+
+    for(const bool equilibration : { true, false })
+    {
+        const unsigned long steps = equilibration ? prms.stepsEquil : prms.stepsProd;
+        for(unsigned long done = 0; done < steps; done += prms.printFreq)
+        {
+            if( aborted.load() )
+                return;
+            host.run(prms.printFreq, equilibration);
+        }
+    }
+
+    std::ostringstream line;
+    host.print_averages(line);
+    lines[i] = line.str();
+    ++completed;
+}
+
+
+
+void SweepExecutor::abort()
+{
+    // running points stop after their current chunk, waiting points are skipped
+
+    aborted.store(true);
+}
+
+
+
+void SweepExecutor::print_averages() const
+{
+    // append all finished points in sweep order, unfinished points of an aborted sweep are left out
+
+    if( points.empty() )
+        return;
+
+    std::string filekeystring = points.front().fileKey;
+    std::string filekey = filekeystring.substr( 0, filekeystring.find_first_of(" ") );
+    filekey.append(".averaged_data");
+
+    std::ofstream FILE;
+    if( ! enhance::fileExists(filekey) )
+    {
+        FILE.open(filekey);
+        MonteCarloHost::print_averages_header(FILE);
+    }
+    else
+    {
+        FILE.open(filekey, std::ios::app);
+    }
+
+    for(const auto& line : lines)
+        FILE << line;
+
+    FILE.close();
+
+    Logger::getInstance().write_new_line("[sweep]", completed.load(), "of", points.size(), "points done with", threads, "threads");
+}
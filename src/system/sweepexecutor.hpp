@@ -0,0 +1,40 @@
+#pragma once
+
+#include "montecarlohost.hpp"
+#include "parameters.hpp"
+#include "parametersio.hpp"
+#include "utility/workstealingpool.hpp"
+#include "utility/logger.hpp"
+#include <vector>
+#include <string>
+#include <sstream>
+#include <atomic>
+#include <thread>
+
+
+
+// Parameter sweep of the advanced run mode: every sweep point is an independent job
+// on a work-stealing pool with its own MonteCarloHost and random stream (point i uses stream i+1),
+// so the results do not depend on the number of threads or on the order the jobs finish in.
+// Only the hosts of running jobs are alive, the averages are merged in sweep order.
+class SweepExecutor
+{
+private:
+    std::vector<Parameters> points {};
+    std::vector<std::string> lines {};          // averaged data of every point, empty until it is done
+    unsigned int threads {1};
+    std::atomic<std::size_t> completed {0};
+    std::atomic<bool> aborted {false};
+
+    void runPoint(const std::size_t);
+
+public:
+    void setup(const std::vector<Parameters>&);
+    void run();
+    void abort();
+
+    inline auto size() const { return points.size(); }
+    inline auto getCompleted() const { return completed.load(); }
+
+    void print_averages() const;
+};
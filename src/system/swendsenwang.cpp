@@ -0,0 +1,168 @@
+#include "swendsenwang.hpp"
+#include <cmath>
+#include <utility>
+
+
+
+void SwendsenWang::update(const double J, const double B, const double T)
+{
+    // bond probability 1 - exp(-2|J|/T) as threshold for the raw engine output
+
+    interaction = J;
+    magnetic = B;
+    temperature = T;
+
+    bondThreshold = AcceptanceTable::scale( T <= 0 ? ( J != 0 ? 1.0 : 0.0 ) : -std::expm1(-2.0*std::fabs(J)/T) );
+}
+
+
+
+void SwendsenWang::resize(const unsigned int _size)
+{
+    // allocate labels for all sites, must not be called while threads are sweeping
+
+    if( _size == size )
+        return;
+
+    size = _size;
+    parents.reset(new std::atomic<unsigned int>[size]);
+    clusterSums.reset(new std::atomic<int>[size]);
+    decisions.assign(size, 0);
+    flipped.assign(size, 0);
+}
+
+
+
+unsigned int SwendsenWang::find(unsigned int id)
+{
+    // root of the cluster of id, with path halving
+    // links only ever point to ancestors, so concurrent halving keeps the forest intact
+
+    while( true )
+    {
+        unsigned int parent = parents[id].load(std::memory_order_relaxed);
+        if( parent == id )
+            return id;
+        const unsigned int grandparent = parents[parent].load(std::memory_order_relaxed);
+        if( grandparent != parent )
+            parents[id].compare_exchange_weak(parent, grandparent, std::memory_order_relaxed);
+        id = grandparent;
+    }
+}
+
+
+
+void SwendsenWang::unite(unsigned int a, unsigned int b)
+{
+    // join the clusters of a and b, the larger root is linked below the smaller one,
+    // the link only succeeds if the larger root is still a root
+
+    while( true )
+    {
+        a = find(a);
+        b = find(b);
+        if( a == b )
+            return;
+        if( a < b )
+            std::swap(a, b);
+        unsigned int expected = a;
+        if( parents[a].compare_exchange_strong(expected, b, std::memory_order_relaxed) )
+            return;
+    }
+}
+
+
+
+void SwendsenWang::sweep(Lattice& lattice, const unsigned int rowBegin, const unsigned int rowEnd, Barrier& barrier, std::vector<VectorEngine>& engines, long& interactionChange, long& magneticChange)
+{
+    const unsigned int width = lattice.getWidth();
+    const unsigned int height = lattice.getHeight();
+    const unsigned int begin = rowBegin * width;
+    const unsigned int end = rowEnd * width;
+    const int bondSign = (interaction >= 0 ? +1 : -1);
+    const bool field = (magnetic != 0);
+
+    // bonds to the right and below of every site, each bond of the Hamiltonian is visited once
+    auto rightOf = [&](const unsigned int id){ return id % width == width - 1 ? id + 1 - width : id + 1; };
+    auto belowOf = [&](const unsigned int id){ return id / width == height - 1 ? id % width : id + width; };
+
+    // every site starts as a cluster of its own
+    for(unsigned int id=begin; id<end; ++id)
+    {
+        parents[id].store(id, std::memory_order_relaxed);
+        clusterSums[id].store(0, std::memory_order_relaxed);
+    }
+    barrier.wait();
+
+    // place bonds and join clusters, links of a spin to itself are no bonds
+    for(unsigned int row=rowBegin; row<rowEnd; ++row)
+    {
+        auto& engine = engines[row];
+        for(unsigned int id=row*width; id<(row+1)*width; ++id)
+        {
+            const int spin = lattice.getType(id);
+            for(const auto neighbour : { rightOf(id), belowOf(id) })
+            {
+                if( neighbour == id || spin * lattice.getType(neighbour) != bondSign )
+                    continue;
+                if( bondThreshold == AcceptanceTable::always || engine() < bondThreshold )
+                    unite(id, neighbour);
+            }
+        }
+    }
+    barrier.wait();
+
+    // in a field the flip probability depends on the spin sum of the cluster
+    if( field )
+    {
+        for(unsigned int id=begin; id<end; ++id)
+            clusterSums[find(id)].fetch_add(lattice.getType(id), std::memory_order_relaxed);
+        barrier.wait();
+    }
+
+    // every root decides for its cluster, roots are the smallest site of their cluster
+    // whatever the order of the joins was
+    for(unsigned int row=rowBegin; row<rowEnd; ++row)
+    {
+        auto& engine = engines[row];
+        for(unsigned int id=row*width; id<(row+1)*width; ++id)
+        {
+            if( parents[id].load(std::memory_order_relaxed) != id )
+                continue;
+            std::uint64_t threshold = std::uint64_t(1) << 63;
+            if( field )
+            {
+                // heat-bath probability 1/(1+exp(dE/T)) of the field energy change dE = 2*B*sum
+                const double energyChange = 2.0 * magnetic * clusterSums[id].load(std::memory_order_relaxed);
+                threshold = AcceptanceTable::scale( temperature <= 0 ? ( energyChange < 0 ? 1.0 : ( energyChange > 0 ? 0.0 : 0.5 ) )
+                                                                     : 1.0 / (1.0 + std::exp(energyChange/temperature)) );
+            }
+            decisions[id] = ( threshold == AcceptanceTable::always || engine() < threshold );
+        }
+    }
+    barrier.wait();
+
+    for(unsigned int id=begin; id<end; ++id)
+        flipped[id] = decisions[find(id)];
+    barrier.wait();
+
+    // changes from the old spins, bonds change only between flipped and unflipped sites
+    for(unsigned int id=begin; id<end; ++id)
+    {
+        const int spin = lattice.getType(id);
+        if( flipped[id] )
+            magneticChange += -2 * spin;
+        for(const auto neighbour : { rightOf(id), belowOf(id) })
+        {
+            if( flipped[id] != flipped[neighbour] )
+                interactionChange += -2 * spin * lattice.getType(neighbour);
+        }
+    }
+    barrier.wait();
+
+    for(unsigned int id=begin; id<end; ++id)
+    {
+        if( flipped[id] )
+            lattice.flip(id);
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "lattice.hpp"
+#include "acceptancetable.hpp"
+#include "vectorengine.hpp"
+#include "utility/barrier.hpp"
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+
+
+
+// Swendsen-Wang update of a nearest-neighbour Ising lattice, run by several threads at once.
+// Every thread owns a band of rows. The Fortuin-Kasteleyn bonds of the band are
+// placed with probability 1 - exp(-2|J|/T) on bonds with J*s_i*s_j > 0 and joined
+// in a lock-free union-find, afterwards every cluster flips with probability 1/2,
+// or with its heat-bath probability in a magnetic field.
+class SwendsenWang
+{
+private:
+    double interaction {0};
+    double magnetic {0};
+    double temperature {1};
+    std::uint64_t bondThreshold {0};    // bond probability times 2^64
+
+    unsigned int size {0};
+    std::unique_ptr<std::atomic<unsigned int>[]> parents {};   // union-find forest, roots point to themselves
+    std::unique_ptr<std::atomic<int>[]> clusterSums {};        // sum of spins of every cluster, stored at its root
+    std::vector<std::uint8_t> decisions {};                    // 1 if the cluster of this root flips
+    std::vector<std::uint8_t> flipped {};                      // 1 if this site flips
+
+    unsigned int find(unsigned int);
+    void unite(unsigned int, unsigned int);
+
+public:
+    void update(const double, const double, const double);     // J, B, T
+    void resize(const unsigned int);
+
+    // one update, has to be called by all threads sharing the barrier with their own band of rows,
+    // every row draws from its own engine, so the result does not depend on the number of threads
+    void sweep(Lattice&, const unsigned int, const unsigned int, Barrier&, std::vector<VectorEngine>&, long&, long&);
+};
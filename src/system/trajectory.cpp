@@ -0,0 +1,249 @@
+#include "trajectory.hpp"
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+
+constexpr std::size_t TrajectoryReader::header;
+
+
+
+namespace
+{
+    const char magic[8] = { 'I', 'S', 'I', 'N', 'G', 'T', 'R', 'J' };
+    constexpr std::uint32_t version = 1;
+    constexpr std::uint32_t byteOrder = 0x01020304;
+
+    struct Header
+    {
+        char          magic[8];
+        std::uint32_t version;
+        std::uint32_t byteOrder;
+        std::uint32_t width;
+        std::uint32_t height;
+        std::uint64_t frameBytes;
+        char          reserved[32];
+    };
+    static_assert( sizeof(Header) == TrajectoryReader::header, "trajectory header has to take 64 bytes" );
+
+
+    std::size_t frameBytes(const unsigned int width, const unsigned int height)
+    {
+        // step, energy and magnetisation, then the packed spins
+        return 8 * ( 3 + (std::size_t(width) * height + 63) / 64 );
+    }
+
+
+    void checkHeader(const Header& head, const std::string& filename)
+    {
+        if( std::memcmp(head.magic, magic, 8) != 0 )
+            throw std::runtime_error(filename + " is no trajectory");
+        if( head.version != version )
+            throw std::runtime_error(filename + " has an unknown trajectory version");
+        if( head.byteOrder != byteOrder )
+            throw std::runtime_error(filename + " was written with a different byte order");
+        if( head.frameBytes != frameBytes(head.width, head.height) )
+            throw std::runtime_error(filename + " has an inconsistent frame size");
+    }
+}
+
+
+
+TrajectoryWriter::~TrajectoryWriter()
+{
+    close();
+}
+
+
+
+void TrajectoryWriter::writeAll(const char* bytes, const std::size_t size, const std::size_t offset)
+{
+    std::size_t written = 0;
+    while( written < size )
+    {
+        const auto result = ::pwrite(descriptor, bytes + written, size - written, offset + written);
+        if( result < 0 && errno == EINTR )
+            continue;
+        if( result <= 0 )
+            throw std::runtime_error("cannot write " + filename + ": " + std::strerror(errno));
+        written += static_cast<std::size_t>(result);
+    }
+}
+
+
+
+void TrajectoryWriter::open(const std::string& _filename, const unsigned int _width, const unsigned int _height, const std::size_t keep)
+{
+    // keep the first frames of an existing file, e.g. those before a checkpoint, or start a new one
+
+    close();
+    filename = _filename;
+    width = _width;
+    height = _height;
+    buffer.assign(frameBytes(width, height) / 8, 0);
+
+    descriptor = ::open(filename.c_str(), O_RDWR | O_CREAT | ( keep == 0 ? O_TRUNC : 0 ), 0644);
+    if( descriptor < 0 )
+        throw std::runtime_error("cannot open " + filename + ": " + std::strerror(errno));
+
+    if( keep == 0 )
+    {
+        Header head {};
+        std::memcpy(head.magic, magic, 8);
+        head.version = version;
+        head.byteOrder = byteOrder;
+        head.width = width;
+        head.height = height;
+        head.frameBytes = frameBytes(width, height);
+        writeAll(reinterpret_cast<const char*>(&head), sizeof(head), 0);
+        frames = 0;
+        return;
+    }
+
+    Header head {};
+    struct stat status {};
+    if( ::pread(descriptor, &head, sizeof(head), 0) != sizeof(head) || ::fstat(descriptor, &status) != 0 )
+    {
+        close();
+        throw std::runtime_error(filename + " is no trajectory");
+    }
+    try
+    {
+        checkHeader(head, filename);
+        if( head.width != width || head.height != height )
+            throw std::runtime_error(filename + " holds a lattice of a different size");
+        if( (static_cast<std::size_t>(status.st_size) - sizeof(head)) / head.frameBytes < keep )
+            throw std::runtime_error(filename + " holds fewer frames than expected");
+    }
+    catch(const std::exception&)
+    {
+        close();
+        throw;
+    }
+    truncate(keep);
+}
+
+
+
+void TrajectoryWriter::append(const unsigned long step, const double energy, const double magnetisation, const Lattice& lattice)
+{
+    assert( lattice.getWidth() == width && lattice.getHeight() == height );
+
+    buffer[0] = step;
+    std::memcpy(&buffer[1], &energy, sizeof(energy));
+    std::memcpy(&buffer[2], &magnetisation, sizeof(magnetisation));
+    lattice.pack(&buffer[3]);
+
+    const std::size_t bytes = buffer.size() * sizeof(std::uint64_t);
+    writeAll(reinterpret_cast<const char*>(buffer.data()), bytes, TrajectoryReader::header + frames * bytes);
+    ++frames;
+}
+
+
+
+void TrajectoryWriter::truncate(const std::size_t keep)
+{
+    // also cuts off a frame left incomplete by a crash
+
+    if( ::ftruncate(descriptor, TrajectoryReader::header + keep * frameBytes(width, height)) != 0 )
+        throw std::runtime_error("cannot truncate " + filename + ": " + std::strerror(errno));
+    frames = keep;
+}
+
+
+
+void TrajectoryWriter::close()
+{
+    if( descriptor >= 0 )
+        ::close(descriptor);
+    descriptor = -1;
+}
+
+
+
+TrajectoryReader::TrajectoryReader(const std::string& filename)
+{
+    // map the whole file, the pages are only read when a frame is accessed
+
+    const int descriptor = ::open(filename.c_str(), O_RDONLY);
+    if( descriptor < 0 )
+        throw std::runtime_error("cannot open " + filename + ": " + std::strerror(errno));
+    struct stat status {};
+    if( ::fstat(descriptor, &status) != 0 || static_cast<std::size_t>(status.st_size) < header )
+    {
+        ::close(descriptor);
+        throw std::runtime_error(filename + " is no trajectory");
+    }
+    length = status.st_size;
+    void* mapping = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, descriptor, 0);
+    ::close(descriptor);
+    if( mapping == MAP_FAILED )
+        throw std::runtime_error("cannot map " + filename + ": " + std::strerror(errno));
+    data = static_cast<const char*>(mapping);
+
+    Header head {};
+    std::memcpy(&head, data, sizeof(head));
+    try
+    {
+        checkHeader(head, filename);
+    }
+    catch(const std::exception&)
+    {
+        ::munmap(const_cast<char*>(data), length);
+        throw;
+    }
+    width = head.width;
+    height = head.height;
+    frameBytes = head.frameBytes;
+    frames = (length - header) / frameBytes;
+}
+
+
+
+TrajectoryReader::~TrajectoryReader()
+{
+    ::munmap(const_cast<char*>(data), length);
+}
+
+
+
+unsigned long TrajectoryReader::getStep(const std::size_t k) const
+{
+    assert( k < frames );
+    return frame(k)[0];
+}
+
+
+
+double TrajectoryReader::getEnergy(const std::size_t k) const
+{
+    assert( k < frames );
+    double energy;
+    std::memcpy(&energy, &frame(k)[1], sizeof(energy));
+    return energy;
+}
+
+
+
+double TrajectoryReader::getMagnetisation(const std::size_t k) const
+{
+    assert( k < frames );
+    double magnetisation;
+    std::memcpy(&magnetisation, &frame(k)[2], sizeof(magnetisation));
+    return magnetisation;
+}
+
+
+
+void TrajectoryReader::getSpins(const std::size_t k, Lattice& lattice) const
+{
+    assert( k < frames );
+    if( lattice.getWidth() != width || lattice.getHeight() != height )
+        lattice.resize(width, height);
+    lattice.unpack(&frame(k)[3]);
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "lattice.hpp"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+
+
+// Trajectory files of lattice snapshots, one bit per spin:
+//
+//   header   magic "ISINGTRJ", version, byte order mark, width, height, bytes per frame (64 bytes)
+//   frame k  step, energy, magnetisation, (width*height+63)/64 words of spins (see Lattice::pack)
+//
+// All frames of a file have the same size, so frame k starts at 64 + k * frame bytes and
+// every value is 8 byte aligned. A frame cut off by a crash is ignored when read.
+
+
+
+// Appends frames, an existing file of the same lattice is continued.
+class TrajectoryWriter
+{
+private:
+    int           descriptor {-1};
+    std::string   filename {};
+    unsigned int  width {0};
+    unsigned int  height {0};
+    std::size_t   frames {0};
+    std::vector<std::uint64_t> buffer {};   // one frame
+
+    void writeAll(const char*, const std::size_t, const std::size_t);
+
+public:
+    TrajectoryWriter() = default;
+    TrajectoryWriter(const TrajectoryWriter&) = delete;
+    void operator=(const TrajectoryWriter&) = delete;
+    ~TrajectoryWriter();
+
+    void open(const std::string&, const unsigned int, const unsigned int, const std::size_t);   // file, width, height, frames to keep
+    void append(const unsigned long, const double, const double, const Lattice&);               // step, energy, magnetisation
+    void truncate(const std::size_t);
+    void close();
+
+    inline bool isOpen() const { return descriptor >= 0; }
+    inline auto size() const { return frames; }
+    inline const auto& getFilename() const { return filename; }
+};
+
+
+
+// Read-only memory map of a trajectory file, frames are accessed in place without parsing.
+class TrajectoryReader
+{
+private:
+    const char*   data {nullptr};
+    std::size_t   length {0};
+    unsigned int  width {0};
+    unsigned int  height {0};
+    std::size_t   frameBytes {0};
+    std::size_t   frames {0};
+
+    inline const std::uint64_t* frame(const std::size_t k) const
+    {
+        return reinterpret_cast<const std::uint64_t*>(data + header + k * frameBytes);
+    }
+
+public:
+    static constexpr std::size_t header = 64;
+
+    explicit TrajectoryReader(const std::string&);
+    TrajectoryReader(const TrajectoryReader&) = delete;
+    void operator=(const TrajectoryReader&) = delete;
+    ~TrajectoryReader();
+
+    inline auto size()      const { return frames; }
+    inline auto getWidth()  const { return width; }
+    inline auto getHeight() const { return height; }
+
+    unsigned long getStep(const std::size_t) const;
+    double getEnergy(const std::size_t) const;
+    double getMagnetisation(const std::size_t) const;
+    inline int getSpin(const std::size_t k, const unsigned int id) const
+    {
+        return ( frame(k)[3 + id / 64] >> (id % 64) ) & 1 ? +1 : -1;
+    }
+    void getSpins(const std::size_t, Lattice&) const;   // resizes the lattice if needed
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+
+
+// Eight independent xoshiro256+ streams, one per 64 bit lane of a SIMD register.
+// Vector kernels advance all lanes at once, operator() draws from lane 0 only,
+// so the engine can also be used wherever a scalar engine is expected.
+class VectorEngine
+{
+public:
+    typedef std::uint64_t result_type;
+    static constexpr unsigned int lanes = 8;
+
+    // four state words per stream, stored word by word: state[word*lanes + lane]
+    std::array<result_type, 4*lanes> state {};
+
+    explicit VectorEngine(const result_type value = 0) { seed(value); }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    inline void seed(result_type);
+    inline result_type operator()();
+};
+
+
+
+inline void VectorEngine::seed(result_type value)
+{
+    // fill all streams with the splitmix64 sequence of the seed
+
+    for(auto& word : state)
+    {
+        value += 0x9e3779b97f4a7c15;
+        result_type z = value;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        word = z ^ (z >> 31);
+    }
+}
+
+
+
+inline VectorEngine::result_type VectorEngine::operator()()
+{
+    result_type& s0 = state[0];
+    result_type& s1 = state[lanes];
+    result_type& s2 = state[2*lanes];
+    result_type& s3 = state[3*lanes];
+
+    const result_type result = s0 + s3;
+    const result_type t = s1 << 17;
+    s2 ^= s0;
+    s3 ^= s1;
+    s1 ^= s2;
+    s0 ^= s3;
+    s2 ^= t;
+    s3 = (s3 << 45) | (s3 >> 19);
+    return result;
+}
@@ -0,0 +1,35 @@
+#include "wolffcluster.hpp"
+
+
+
+void WolffCluster::update(const double J, const double B, const double T)
+{
+    // bond probability 1 - exp(-2|J|/T) as threshold for the raw engine output
+
+    interaction = J;
+    magnetic = B;
+    temperature = T;
+
+    addThreshold = AcceptanceTable::scale( T <= 0 ? ( J != 0 ? 1.0 : 0.0 ) : -std::expm1(-2.0*std::fabs(J)/T) );
+}
+
+
+
+void WolffCluster::prepare(const unsigned int size)
+{
+    // start a new cluster, marks are only cleared when the generation counter wraps
+
+    if( marks.size() != size )
+    {
+        marks.assign(size, 0);
+        members.reserve(size);
+        generation = 0;
+    }
+
+    members.clear();
+    if( ++generation == 0 )
+    {
+        std::fill(std::begin(marks), std::end(marks), 0);
+        generation = 1;
+    }
+}
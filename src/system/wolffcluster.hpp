@@ -0,0 +1,99 @@
+#pragma once
+
+#include "lattice.hpp"
+#include "acceptancetable.hpp"
+#include "lib/enhance.hpp"
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+
+
+
+// Wolff single-cluster update of a nearest-neighbour Ising lattice.
+// A cluster grows from a random seed over bonds with J*s_i*s_j > 0, each one
+// added with probability 1 - exp(-2|J|/T), and is flipped as a whole.
+// A magnetic field enters as Metropolis acceptance of the complete cluster flip.
+// Member list and marks are kept between updates, so no update allocates.
+class WolffCluster
+{
+private:
+    double interaction {0};
+    double magnetic {0};
+    double temperature {1};
+    std::uint64_t addThreshold {0};     // bond probability times 2^64
+
+    std::vector<unsigned int> members {};   // queue during growth, list of the cluster afterwards
+    std::vector<unsigned int> marks {};     // marks[id] == generation if id belongs to the current cluster
+    unsigned int generation {0};
+
+    void prepare(const unsigned int);
+
+public:
+    void update(const double, const double, const double);     // J, B, T
+
+    template<typename ENGINE>
+    bool flip(Lattice&, ENGINE&, long&, long&);
+
+    inline auto size() const { return members.size(); }        // size of the last cluster
+};
+
+
+
+template<typename ENGINE>
+bool WolffCluster::flip(Lattice& lattice, ENGINE& engine, long& interactionChange, long& magneticChange)
+{
+    // grow one cluster and flip it, the changes of interaction and spin sum are accumulated
+    // returns false if the flip is rejected by the magnetic field
+
+    prepare(lattice.size());
+
+    const unsigned int seed = static_cast<unsigned int>( enhance::bounded(engine, lattice.size()) );
+    const int bondSign = (interaction >= 0 ? +1 : -1);
+    marks[seed] = generation;
+    members.push_back(seed);
+
+    for(std::size_t next = 0; next < members.size(); ++next)
+    {
+        const unsigned int id = members[next];
+        const int spin = lattice.getType(id);
+        for(const auto neighbour : lattice.getNeighbours(id))
+        {
+            if( marks[neighbour] == generation || spin * lattice.getType(neighbour) != bondSign )
+                continue;
+            if( addThreshold == AcceptanceTable::always || engine() < addThreshold )
+            {
+                marks[neighbour] = generation;
+                members.push_back(neighbour);
+            }
+        }
+    }
+
+    // changes are found from the bonds leaving the cluster
+    long interactionSum = 0;
+    long spinSum = 0;
+    for(const auto id : members)
+    {
+        const int spin = lattice.getType(id);
+        spinSum += spin;
+        for(const auto neighbour : lattice.getNeighbours(id))
+        {
+            if( marks[neighbour] != generation )
+                interactionSum += spin * lattice.getType(neighbour);
+        }
+    }
+
+    // metropolis acceptance of the field energy -B*dM
+    if( magnetic != 0 )
+    {
+        const double fieldChange = 2.0 * magnetic * spinSum;
+        if( fieldChange > 0 && ( temperature <= 0 || enhance::canonical(engine) >= std::exp(-fieldChange/temperature) ) )
+            return false;
+    }
+
+    for(const auto id : members)
+        lattice.flip(id);
+    interactionChange += -2 * interactionSum;
+    magneticChange += -2 * spinSum;
+    return true;
+}
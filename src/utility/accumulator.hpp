@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+
+
+// Streaming statistics of a series in constant memory: count, mean, central moments
+// up to the fourth, minimum and maximum. Every sample updates the moments about the
+// running mean (Welford, Pebay), so no catastrophic cancellation as in <x^2>-<x>^2.
+// Plain value type, it can be copied and written to checkpoints as it is.
+class Accumulator
+{
+private:
+    std::size_t count {0};
+    double mean {0};
+    double M2 {0};      // sums of (x - mean)^k
+    double M3 {0};
+    double M4 {0};
+    double min { std::numeric_limits<double>::infinity() };
+    double max { -std::numeric_limits<double>::infinity() };
+
+public:
+    inline void add(const double x)
+    {
+        const double n1 = static_cast<double>(count);
+        const double n = n1 + 1;
+        const double delta = x - mean;
+        const double deltaN = delta / n;
+        const double deltaN2 = deltaN * deltaN;
+        const double term = delta * deltaN * n1;
+
+        ++count;
+        mean += deltaN;
+        M4 += term * deltaN2 * (n*n - 3*n + 3) + 6 * deltaN2 * M2 - 4 * deltaN * M3;
+        M3 += term * deltaN * (n - 2) - 3 * deltaN * M2;
+        M2 += term;
+        min = std::min(min, x);
+        max = std::max(max, x);
+    }
+
+    // as if all samples of other had been added to this one (Chan, Pebay)
+    inline void merge(const Accumulator& other)
+    {
+        if( other.count == 0 )
+            return;
+        if( count == 0 )
+        {
+            *this = other;
+            return;
+        }
+
+        const double na = static_cast<double>(count);
+        const double nb = static_cast<double>(other.count);
+        const double n = na + nb;
+        const double delta = other.mean - mean;
+        const double delta2 = delta * delta;
+
+        M4 += other.M4 + delta2*delta2 * na*nb * (na*na - na*nb + nb*nb) / (n*n*n)
+                       + 6 * delta2 * (na*na*other.M2 + nb*nb*M2) / (n*n)
+                       + 4 * delta * (na*other.M3 - nb*M3) / n;
+        M3 += other.M3 + delta2*delta * na*nb * (na - nb) / (n*n)
+                       + 3 * delta * (na*other.M2 - nb*M2) / n;
+        M2 += other.M2 + delta2 * na*nb / n;
+        mean += delta * nb / n;
+        count += other.count;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
+
+    inline void clear() { *this = Accumulator(); }
+
+    inline auto getCount() const { return count; }
+    inline auto getMin()   const { return min; }
+    inline auto getMax()   const { return max; }
+
+    // NaN without samples
+    inline double getMean() const { return count == 0 ? std::numeric_limits<double>::quiet_NaN() : mean; }
+    inline double getVariance() const { return M2 / count; }   // of the samples, not of their mean
+
+    // <x^k> for k = 1 ... 4
+    inline double getMoment(const unsigned int k) const
+    {
+        const double c2 = M2 / count;
+        const double c3 = M3 / count;
+        const double c4 = M4 / count;
+        switch( k )
+        {
+            case 1 :    return getMean();
+            case 2 :    return c2 + mean*mean;
+            case 3 :    return c3 + 3*mean*c2 + mean*mean*mean;
+            case 4 :    return c4 + 4*mean*c3 + 6*mean*mean*c2 + mean*mean*mean*mean;
+            default :   return std::numeric_limits<double>::quiet_NaN();
+        }
+    }
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+
+
+
+// Reusable barrier for a fixed number of threads.
+// Every thread calling wait() blocks until all threads have arrived,
+// afterwards the barrier is ready for the next phase.
+class Barrier
+{
+public:
+    explicit Barrier(const std::size_t _threshold)
+      : threshold(_threshold)
+      , count(_threshold)
+    {}
+
+    Barrier(const Barrier&) = delete;
+    void operator=(const Barrier&) = delete;
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        const std::size_t arrivalGeneration = generation;
+        if( --count == 0 )
+        {
+            ++generation;
+            count = threshold;
+            condition.notify_all();
+        }
+        else
+        {
+            condition.wait(lock, [&]{ return arrivalGeneration != generation; });
+        }
+    }
+
+private:
+    std::mutex mutex {};
+    std::condition_variable condition {};
+    const std::size_t threshold;
+    std::size_t count;
+    std::size_t generation {0};
+};
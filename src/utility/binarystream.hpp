@@ -0,0 +1,102 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+#include <stdexcept>
+
+
+
+// Plain binary serialisation into a byte buffer, values are stored in the byte order of the machine.
+// Only trivially copyable values, vectors of them and strings are supported.
+class BinaryWriter
+{
+private:
+    std::string buffer {};
+
+public:
+    template<typename T>
+    void write(const T& value)
+    {
+        static_assert( std::is_trivially_copyable<T>::value, "BinaryWriter::write needs a trivially copyable type" );
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    void write(const std::vector<T>& values)
+    {
+        static_assert( std::is_trivially_copyable<T>::value, "BinaryWriter::write needs a trivially copyable type" );
+        write<std::uint64_t>(values.size());
+        buffer.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    }
+
+    void write(const std::string& text)
+    {
+        write<std::uint64_t>(text.size());
+        buffer.append(text);
+    }
+
+    inline const std::string& data() const { return buffer; }
+};
+
+
+
+// Counterpart of BinaryWriter, reading past the end throws std::runtime_error.
+class BinaryReader
+{
+private:
+    const std::string& buffer;
+    std::size_t position {0};
+
+    void check(const std::size_t bytes) const
+    {
+        if( bytes > buffer.size() - position )
+            throw std::runtime_error("binary data ends unexpectedly");
+    }
+
+public:
+    explicit BinaryReader(const std::string& _buffer) : buffer(_buffer) {}
+
+    template<typename T>
+    void read(T& value)
+    {
+        static_assert( std::is_trivially_copyable<T>::value, "BinaryReader::read needs a trivially copyable type" );
+        check(sizeof(T));
+        std::memcpy(&value, buffer.data() + position, sizeof(T));
+        position += sizeof(T);
+    }
+
+    template<typename T>
+    void read(std::vector<T>& values)
+    {
+        static_assert( std::is_trivially_copyable<T>::value, "BinaryReader::read needs a trivially copyable type" );
+        std::uint64_t size = 0;
+        read(size);
+        if( size > (buffer.size() - position) / sizeof(T) )
+            throw std::runtime_error("binary data ends unexpectedly");
+        values.resize(size);
+        std::memcpy(values.data(), buffer.data() + position, size * sizeof(T));
+        position += size * sizeof(T);
+    }
+
+    void read(std::string& text)
+    {
+        std::uint64_t size = 0;
+        read(size);
+        check(size);
+        text.assign(buffer, position, size);
+        position += size;
+    }
+
+    template<typename T>
+    T get()
+    {
+        T value {};
+        read(value);
+        return value;
+    }
+
+    inline bool atEnd() const { return position == buffer.size(); }
+};
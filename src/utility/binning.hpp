@@ -0,0 +1,145 @@
+#pragma once
+
+#include "accumulator.hpp"
+#include <array>
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <cmath>
+#include <limits>
+
+
+
+// Error analysis of a correlated series while it is recorded, in constant memory:
+//
+// Logarithmic binning: level l holds the statistics of the means of 2^l consecutive samples.
+// Once the bins are longer than the correlation time their means are independent and the
+// naive error of the mean at that level is the true one. The ratio of the squared errors at
+// that level and at level 0 is 2*tau_int, tau_int in samples and 0.5 for uncorrelated samples.
+//
+// Jackknife blocks: a fixed number of consecutive blocks, pairwise merged once all are full,
+// for the errors of nonlinear estimates like variances or the Binder cumulant.
+//
+// Both are only reliable if the run is many times longer than tau_int, see isConverged().
+// Plain value type, it can be copied and written to checkpoints as it is.
+class Binning
+{
+public:
+    static constexpr unsigned int levels = 48;          // up to 2^47 samples per bin
+    static constexpr unsigned int blocks = 64;          // jackknife blocks, even
+    static constexpr std::size_t minimumBins = 128;     // bins of the level used for the error
+
+private:
+    std::array<Accumulator, levels> binMeans {};
+    std::array<double, levels> pending {};              // first half of the next bin of a level
+    std::array<bool, levels> waiting {};
+
+    std::array<Accumulator, blocks> blockStatistics {};
+    std::size_t blockSize {1};                          // samples per full block
+    unsigned int fullBlocks {0};                        // block fullBlocks is being filled
+
+public:
+    inline void add(const double x)
+    {
+        // every second bin of a level completes a bin of the next level
+        double value = x;
+        for(unsigned int l=0; l<levels; ++l)
+        {
+            binMeans[l].add(value);
+            if( ! waiting[l] )
+            {
+                pending[l] = value;
+                waiting[l] = true;
+                break;
+            }
+            value = 0.5 * (pending[l] + value);
+            waiting[l] = false;
+        }
+
+        blockStatistics[fullBlocks].add(x);
+        if( blockStatistics[fullBlocks].getCount() < blockSize )
+            return;
+        if( ++fullBlocks < blocks )
+            return;
+
+        // all blocks full: merge neighbours into blocks of twice the size
+        for(unsigned int b=0; b<blocks/2; ++b)
+        {
+            blockStatistics[b] = blockStatistics[2*b];
+            blockStatistics[b].merge(blockStatistics[2*b + 1]);
+        }
+        for(unsigned int b=blocks/2; b<blocks; ++b)
+            blockStatistics[b].clear();
+        fullBlocks = blocks/2;
+        blockSize *= 2;
+    }
+
+    inline void clear() { *this = Binning(); }
+
+    // statistics of all samples
+    inline const Accumulator& getTotal() const { return binMeans[0]; }
+
+    // highest level with at least minimumBins bins, 0 for short series
+    inline unsigned int getLevel() const
+    {
+        unsigned int level = 0;
+        while( level+1 < levels && binMeans[level+1].getCount() >= minimumBins )
+            ++level;
+        return level;
+    }
+
+    // error of the mean estimated from the bins of the given level
+    inline double getError(const unsigned int level) const
+    {
+        const auto bins = binMeans[level].getCount();
+        return bins < 2 ? std::numeric_limits<double>::quiet_NaN() : std::sqrt(binMeans[level].getVariance() / (bins - 1));
+    }
+
+    inline double getError() const { return getError(getLevel()); }
+
+    // integrated autocorrelation time in samples, 0.5 for a constant series like a frozen lattice
+    inline double getTau() const
+    {
+        if( getError(0) == 0 )
+            return 0.5;
+        const double ratio = getError() / getError(0);
+        return 0.5 * ratio * ratio;
+    }
+
+    // the error has reached its plateau if the next lower level agrees within three times
+    // the uncertainty of the error, which is about 1/sqrt(2*(bins-1)) relative
+    inline bool isConverged() const
+    {
+        const unsigned int level = getLevel();
+        if( level < 2 )
+            return false;
+        const double lower = getError(level - 1);
+        const double relative = 1.0 / std::sqrt(2.0 * (binMeans[level].getCount() - 1));
+        return std::fabs(getError() - lower) <= 3 * relative * getError();
+    }
+
+    // estimate of f(statistics) from all samples with its jackknife error from the full blocks
+    template<typename FUNCTION>
+    std::pair<double, double> jackknife(FUNCTION&& f) const
+    {
+        const double estimate = f(getTotal());
+        if( fullBlocks < 2 )
+            return { estimate, std::numeric_limits<double>::quiet_NaN() };
+
+        std::vector<double> values(fullBlocks);
+        double mean = 0;
+        for(unsigned int left=0; left<fullBlocks; ++left)
+        {
+            Accumulator rest;
+            for(unsigned int b=0; b<fullBlocks; ++b)
+                if( b != left )
+                    rest.merge(blockStatistics[b]);
+            values[left] = f(rest);
+            mean += values[left] / fullBlocks;
+        }
+        double sum = 0;
+        for(const double value : values)
+            sum += (value - mean) * (value - mean);
+        return { estimate, std::sqrt(sum * (fullBlocks - 1) / fullBlocks) };
+    }
+};
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <algorithm>
+#include <exception>
+#include <cstddef>
+
+
+
+// Fixed set of worker threads, every worker has its own task queue.
+// Workers take tasks from the back of their own queue and steal from the
+// front of the others once it is empty, so long and short tasks even out.
+// Tasks are distributed round robin on submission, which has to happen from one thread.
+// The first exception a task throws is kept and rethrown by wait(), the other tasks still run.
+class WorkStealingPool
+{
+public:
+    typedef std::function<void()> task_type;
+
+    explicit WorkStealingPool(const std::size_t threads)
+    {
+        for(std::size_t t=0; t<std::max<std::size_t>(threads, 1); ++t)
+            queues.emplace_back(new Queue);
+        for(std::size_t t=0; t<queues.size(); ++t)
+            workers.emplace_back([this, t]{ work(t); });
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    void operator=(const WorkStealingPool&) = delete;
+
+    ~WorkStealingPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(idleMutex);
+            stopping = true;
+        }
+        idleCondition.notify_all();
+        for(auto& worker : workers)
+            worker.join();
+    }
+
+    void submit(task_type task)
+    {
+        ++pending;
+        Queue& queue = *queues[next++ % queues.size()];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(idleMutex);
+            ++queued;
+        }
+        idleCondition.notify_one();
+    }
+
+    // block until every submitted task has finished, then rethrow the first exception of a task
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(idleMutex);
+        doneCondition.wait(lock, [&]{ return pending.load() == 0; });
+        if( error )
+        {
+            std::exception_ptr first = error;
+            error = nullptr;
+            std::rethrow_exception(first);
+        }
+    }
+
+    inline auto size() const { return workers.size(); }
+
+private:
+    struct Queue
+    {
+        std::mutex mutex {};
+        std::deque<task_type> tasks {};
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues {};
+    std::vector<std::thread> workers {};
+    std::size_t next {0};
+
+    std::mutex idleMutex {};
+    std::condition_variable idleCondition {};
+    std::condition_variable doneCondition {};
+    std::size_t queued {0};                     // tasks waiting in any queue, guarded by idleMutex
+    std::atomic<std::size_t> pending {0};       // tasks submitted but not finished
+    std::exception_ptr error {};                // first exception of a task, guarded by idleMutex
+    bool stopping {false};
+
+    bool take(const std::size_t self, task_type& task)
+    {
+        // own queue from the back, then the other queues from the front
+
+        for(std::size_t i=0; i<queues.size(); ++i)
+        {
+            Queue& queue = *queues[(self + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if( queue.tasks.empty() )
+                continue;
+            if( i == 0 )
+            {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            else
+            {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            return true;
+        }
+        return false;
+    }
+
+    void work(const std::size_t self)
+    {
+        while( true )
+        {
+            {
+                std::unique_lock<std::mutex> lock(idleMutex);
+                idleCondition.wait(lock, [&]{ return stopping || queued > 0; });
+                if( queued == 0 )
+                    return;
+                --queued;
+            }
+
+            // one queued task is reserved for this worker, it is found in some queue
+            task_type task;
+            while( ! take(self, task) )
+                std::this_thread::yield();
+            try
+            {
+                task();
+            }
+            catch(...)
+            {
+                std::lock_guard<std::mutex> lock(idleMutex);
+                if( ! error )
+                    error = std::current_exception();
+            }
+
+            if( --pending == 0 )
+            {
+                std::lock_guard<std::mutex> lock(idleMutex);
+                doneCondition.notify_all();
+            }
+        }
+    }
+};